@@ -0,0 +1,72 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include "../RayCastDemo/src/Timer.h"
+// Minimal micro-benchmark harness: run a case for a number of warmup passes, then time each of the measured passes
+// and report percentiles. A "pass" is whatever the case does once (eg. cast every ray of every pose).
+namespace Bench {
+	struct Options {
+		int warmup = 10; //untimed passes, to warm caches and branch predictors
+		int repetitions = 100; //timed passes
+	};
+
+	struct Result {
+		std::string_view name;
+		std::string_view variant;
+		double p50_ms = 0.0;
+		double p99_ms = 0.0;
+		double min_ms = 0.0;
+		double rays_per_second = 0.0; //at p50
+	};
+
+	//nearest-rank percentile. Sorts the samples.
+	inline double percentile(std::vector<double>& samples, double p) noexcept {
+		if (samples.empty()) { return 0.0; }
+		std::sort(samples.begin(), samples.end());
+		const auto rank = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+		return samples[std::min(rank, samples.size() - 1)];
+	}
+
+	//keeps results alive so the optimizer can't discard the work we are trying to time
+	inline volatile uint64_t sink = 0;
+	inline void consume(uint64_t value) noexcept {
+		sink = sink + value;
+	}
+
+	// pass() is called warmup + repetitions times. rays is how many rays one pass casts.
+	template<typename Pass>
+	Result run(std::string_view name, std::string_view variant, const Options& opt, uint64_t rays, Pass&& pass) {
+		for (int i = 0; i < opt.warmup; i++) {
+			pass();
+		}
+		std::vector<double> samples;
+		samples.reserve(opt.repetitions);
+		for (int i = 0; i < opt.repetitions; i++) {
+			const auto start = Timer::now();
+			pass();
+			samples.push_back(Timer::millisecondsSince(start));
+		}
+		Result r{ name, variant };
+		r.min_ms = *std::min_element(samples.begin(), samples.end());
+		r.p99_ms = percentile(samples, 0.99);
+		r.p50_ms = percentile(samples, 0.50);
+		r.rays_per_second = (r.p50_ms > 0.0) ? rays / (r.p50_ms / 1000.0) : 0.0;
+		return r;
+	}
+
+	inline void printHeader(std::ostream& out) {
+		out << std::left << std::setw(36) << "case" << std::setw(10) << "map"
+			<< std::right << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "min ms" << std::setw(14) << "Mrays/s" << "\n";
+	}
+
+	inline void print(std::ostream& out, const Result& r) {
+		out << std::left << std::setw(36) << r.name << std::setw(10) << r.variant << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << r.p50_ms << std::setw(10) << r.p99_ms << std::setw(10) << r.min_ms
+			<< std::setw(14) << r.rays_per_second / 1000000.0 << "\n";
+		out.unsetf(std::ios::floatfield);
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../RayCastDemo/src/Config.h"
+#include "../RayCastDemo/src/LevelData.h"
+#include "../RayCastDemo/src/Simulation.h"
+#include "../RayCastDemo/src/ActionTrack.h"
+// Deterministic camera input for the benchmarks: a fixed set of poses covering the whole map, and a scripted walk.
+namespace CameraPaths {
+	static constexpr int HEADINGS = 8; //poses per open cell
+
+	//every open cell, looking in HEADINGS evenly spaced directions
+	inline std::vector<Camera> poses() {
+		std::vector<Camera> result;
+		for (int row = 0; row < WORLD_ROWS; row++) {
+			for (int column = 0; column < WORLD_COLUMNS; column++) {
+				if (isWall(column, row)) { continue; }
+				for (int h = 0; h < HEADINGS; h++) {
+					result.push_back(Camera{ column * CELL_SIZE + (CELL_SIZE >> 1), row * CELL_SIZE + (CELL_SIZE >> 1), (h * ANGLE_360) / HEADINGS });
+				}
+			}
+		}
+		return result;
+	}
+
+	//drives the real Simulation, so the path has the same movement and collisions as the game. One camera per tick.
+	inline std::vector<Camera> replay(const std::vector<Actions>& track) {
+		Simulation sim{};
+		std::vector<Camera> result;
+		result.reserve(track.size());
+		for (const auto& actions : track) {
+			sim.tick(actions);
+			result.push_back(sim.camera());
+		}
+		return result;
+	}
+
+	//a short scripted loop, repeated until we have enough ticks
+	inline std::vector<Camera> walk(int ticks) {
+		static constexpr std::string_view script = "f90 r20 lf45 b30 rf60";
+		std::vector<Actions> track;
+		std::string error;
+		while (static_cast<int>(track.size()) < ticks) {
+			[[maybe_unused]] const bool parsed = ActionTrack::parse(script, track, error);
+			assert(parsed && "CameraPaths: bad walk script");
+		}
+		track.resize(ticks);
+		return replay(track);
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../RayCastDemo/src/BitGrid.h"
+#include "../RayCastDemo/src/Pathfinding.h"
+// Generated test maps for the pathfinders. Seeded, so every run (and every machine) benchmarks the same maps.
+namespace Mazes {
+	// A perfect maze (recursive backtracker) on a (2 * cells + 1)^2 grid. braid is the share of the remaining inner walls
+	// knocked out afterwards: 0 leaves exactly one way between any two cells, more adds loops and open areas.
+	inline BitGrid maze(int cells, float braid, uint32_t seed) {
+		const int size = 2 * cells + 1;
+		BitGrid grid(size, size);
+		std::mt19937 rng(seed);
+		std::vector<uint8_t> visited(static_cast<size_t>(cells) * cells, 0);
+		std::vector<std::pair<int, int>> stack{ { 0, 0 } };
+		visited[0] = 1;
+		grid.setOpen(1, 1, true);
+		static constexpr int DX[4]{ 1, -1, 0, 0 };
+		static constexpr int DY[4]{ 0, 0, 1, -1 };
+		while (!stack.empty()) {
+			const auto [cx, cy] = stack.back();
+			int options[4];
+			int count = 0;
+			for (int d = 0; d < 4; d++) {
+				const int nx = cx + DX[d], ny = cy + DY[d];
+				if (nx >= 0 && nx < cells && ny >= 0 && ny < cells && !visited[static_cast<size_t>(ny) * cells + nx]) { options[count++] = d; }
+			}
+			if (count == 0) {
+				stack.pop_back();
+				continue;
+			}
+			const int d = options[rng() % count];
+			const int nx = cx + DX[d], ny = cy + DY[d];
+			visited[static_cast<size_t>(ny) * cells + nx] = 1;
+			grid.setOpen(2 * cx + 1 + DX[d], 2 * cy + 1 + DY[d], true); //the wall between the two cells
+			grid.setOpen(2 * nx + 1, 2 * ny + 1, true);
+			stack.push_back({ nx, ny });
+		}
+		std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+		for (int y = 1; y < size - 1; y++) {
+			for (int x = 1; x < size - 1; x++) {
+				if (!grid.isOpen(x, y) && ((x ^ y) & 1) && chance(rng) < braid) { grid.setOpen(x, y, true); } //only walls between two cells
+			}
+		}
+		return grid;
+	}
+
+	//scattered single-cell obstacles, density in [0, 1]
+	inline BitGrid scattered(int width, int height, float density, uint32_t seed) {
+		BitGrid grid(width, height);
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				grid.setOpen(x, y, chance(rng) >= density);
+			}
+		}
+		return grid;
+	}
+
+	//rectangular rooms, 8 to 24 cells across, with a door of 1 to 3 cells in every wall. Closer to a level than the mazes.
+	inline BitGrid rooms(int width, int height, uint32_t seed) {
+		BitGrid grid(width, height);
+		std::mt19937 rng(seed);
+		auto walls = [&](int length) {
+			std::vector<int> at{ 0 };
+			while (at.back() + 8 < length - 1) { at.push_back(std::min(at.back() + 8 + static_cast<int>(rng() % 17), length - 1)); }
+			at.back() = length - 1;
+			return at;
+		};
+		const auto columns = walls(width);
+		const auto rows = walls(height);
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				grid.setOpen(x, y, true);
+			}
+		}
+		for (const int x : columns) {
+			for (int y = 0; y < height; y++) { grid.setOpen(x, y, false); }
+		}
+		for (const int y : rows) {
+			for (int x = 0; x < width; x++) { grid.setOpen(x, y, false); }
+		}
+		auto door = [&](int from, int to) { //somewhere strictly between two crossing walls
+			const int at = from + 1 + static_cast<int>(rng() % (to - from - 1));
+			return std::pair{ at, std::min(at + 1 + static_cast<int>(rng() % 3), to) };
+		};
+		for (size_t i = 1; i + 1 < columns.size(); i++) {
+			for (size_t j = 1; j < rows.size(); j++) {
+				const auto [first, last] = door(rows[j - 1], rows[j]);
+				for (int y = first; y < last; y++) { grid.setOpen(columns[i], y, true); }
+			}
+		}
+		for (size_t j = 1; j + 1 < rows.size(); j++) {
+			for (size_t i = 1; i < columns.size(); i++) {
+				const auto [first, last] = door(columns[i - 1], columns[i]);
+				for (int x = first; x < last; x++) { grid.setOpen(x, rows[j], true); }
+			}
+		}
+		return grid;
+	}
+
+	//random pairs of open cells
+	inline std::vector<std::pair<Pathfinding::Point, Pathfinding::Point>> queries(const BitGrid& grid, int count, uint32_t seed) {
+		std::mt19937 rng(seed);
+		auto randomOpen = [&] {
+			while (true) {
+				const Pathfinding::Point p{ static_cast<int>(rng() % grid.width()), static_cast<int>(rng() % grid.height()) };
+				if (grid.isOpen(p.x, p.y)) { return p; }
+			}
+		};
+		std::vector<std::pair<Pathfinding::Point, Pathfinding::Point>> pairs;
+		for (int i = 0; i < count; i++) {
+			const auto start = randomOpen();
+			pairs.push_back({ start, randomOpen() });
+		}
+		return pairs;
+	}
+}
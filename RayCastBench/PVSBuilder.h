@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <vector>
+#include "../RayCastDemo/src/GridTraversal.h"
+#include "../RayCastDemo/src/PVS.h"
+#include "../RayCastDemo/src/RayCaster.h"
+// Offline PVS generation: cast a full circle of rays from a grid of sample points inside every open cell,
+// with the RayCaster's own wall search, and mark every cell each ray passes through on its way to the wall.
+namespace PVSBuilder {
+	struct Options {
+		int samples = 8; //sample points per cell, along each axis
+		int checkedSegments = 2000000; //random sight lines the result is checked against, see missing()
+	};
+
+	//mark the open cells on the way from (x0, y0) to the wall at (x1, y1), the same way lineOfSight() walks them
+	template<auto IsWall>
+	void markSegment(int x0, int y0, int x1, int y1, CellSet& seen) noexcept {
+		GridTraversal::forEachCell(x0, y0, x1, y1, [&](int x, int y) noexcept {
+			if (!IsWall(x, y)) { seen[cellIndex(x, y)] = true; }
+		});
+	}
+
+	template<auto IsWall>
+	PVS::Matrix build(const BasicRayCaster<IsWall>& ray, const Options& opt) {
+		PVS::Matrix visible{};
+		const int spacing = CELL_SIZE / opt.samples;
+		for (const int cell : PVS::openCells<IsWall>()) {
+			const int left = (cell % WORLD_COLUMNS) << CELL_SIZE_FP;
+			const int top = (cell / WORLD_COLUMNS) << CELL_SIZE_FP;
+			for (int sy = 0; sy < opt.samples; sy++) {
+				for (int sx = 0; sx < opt.samples; sx++) {
+					const int x = left + sx * spacing + spacing / 2;
+					const int y = top + sy * spacing + spacing / 2;
+					for (int angle = 0; angle < ANGLE_360; angle++) {
+						const RayEnd vertical = ray.findVerticalWall(x, y, angle);
+						const RayEnd horizontal = ray.findHorizontalWall(x, y, angle);
+						if (vertical < horizontal) {
+							markSegment<IsWall>(x, y, vertical.boundary, vertical.intersection, visible[cell]);
+						} else {
+							markSegment<IsWall>(x, y, horizontal.intersection, horizontal.boundary, visible[cell]);
+						}
+					}
+				}
+			}
+		}
+		for (int a = 0; a < PVS::CELLS; a++) { //A sees B, so B sees A. Covers rays that only one side's samples caught.
+			for (int b = a + 1; b < PVS::CELLS; b++) {
+				const bool either = visible[a][b] || visible[b][a];
+				visible[a][b] = either;
+				visible[b][a] = either;
+			}
+		}
+		return visible;
+	}
+
+	//Random segments between points anywhere inside two open cells: isClear() is the truth the sampled build must cover.
+	//Returns how many of them were clear but their end cell isn't in the start cell's set.
+	template<auto IsWall>
+	size_t missing(const PVS::Matrix& visible, const Options& opt) {
+		static constexpr auto rows = GridTraversal::wallRows<IsWall>();
+		const auto open = PVS::openCells<IsWall>();
+		std::mt19937 rng(9);
+		auto pointIn = [&](int cell) { return (cell << CELL_SIZE_FP) + static_cast<int>(rng() % CELL_SIZE); }; //cell along one axis
+		size_t missed = 0;
+		for (int i = 0; i < opt.checkedSegments; i++) {
+			const int a = open[rng() % open.size()];
+			const int b = open[rng() % open.size()];
+			const GridTraversal::Query q{ pointIn(a % WORLD_COLUMNS), pointIn(a / WORLD_COLUMNS), pointIn(b % WORLD_COLUMNS), pointIn(b / WORLD_COLUMNS) };
+			missed += GridTraversal::isClear(rows, q) && !visible[a][b];
+		}
+		return missed;
+	}
+
+	//write the PVS as a header, to be checked in next to LevelData.h
+	template<auto IsWall>
+	void writeHeader(std::ostream& out, const PVS::Matrix& visible, const Options& opt) {
+		static constexpr int BYTES_PER_LINE = 16;
+		const auto open = PVS::openCells<IsWall>();
+		const auto bytes = PVS::compress(visible, open);
+		size_t pairs = 0;
+		for (const int cell : open) {
+			pairs += visible[cell].count() - 1;
+		}
+		out << "#pragma once\n"
+			<< "#include <cstdint>\n"
+			<< "// Generated by 'RayCastBench pvs --samples " << opt.samples << "'. Don't edit, regenerate after changing the map in LevelData.h.\n"
+			<< "// " << open.size() << " open cells, " << pairs / 2 << " visible pairs. Unpack with PVS::decompress(), see PVS.h.\n"
+			<< "namespace LevelPVS {\n"
+			<< "    static constexpr uint32_t LEVEL_HASH = 0x" << std::hex << std::setfill('0') << std::setw(8) << PVS::levelHash(GridTraversal::wallRows<IsWall>()) << ";\n"
+			<< "    static constexpr uint8_t DATA[" << std::dec << bytes.size() << "] = {";
+		for (size_t i = 0; i < bytes.size(); i++) {
+			out << ((i % BYTES_PER_LINE == 0) ? "\n        " : " ")
+				<< "0x" << std::hex << std::setw(2) << static_cast<int>(bytes[i]) << std::dec << ",";
+		}
+		out << "\n    };\n}\n";
+	}
+}
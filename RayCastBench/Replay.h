@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../RayCastDemo/src/Graphics.h"
+#include "../RayCastDemo/src/IndexedFrameBuffer.h"
+#include "../RayCastDemo/src/MiniMap.h"
+#include "../RayCastDemo/src/RayCaster.h"
+#include "../RayCastDemo/src/Timer.h"
+#include "Bench.h"
+// Golden-frame regression: render a camera path headless, exactly like the game draws a frame, and keep a hash and the
+// render time of every frame. Saved runs can be compared later, for visual and performance regressions in one go.
+namespace Replay {
+	struct Frame {
+		uint64_t hash = 0; //of the 8-bit framebuffer. The palette is fixed, so equal hashes mean equal images.
+		double ms = 0.0;
+	};
+
+	inline uint64_t hash(const IndexedFrameBuffer& fb) noexcept { //FNV-1a
+		uint64_t h = 14695981039346656037ull;
+		const auto size = static_cast<size_t>(fb.width()) * fb.height();
+		for (size_t i = 0; i < size; i++) {
+			h = (h ^ fb.data()[i]) * 1099511628211ull;
+		}
+		return h;
+	}
+
+	inline std::vector<Frame> run(const std::vector<Camera>& cameras) {
+		const RayCaster ray{};
+		IndexedFrameBuffer fb{ Cfg::WIN_WIDTH, Cfg::WIN_HEIGHT };
+		fb.setPalette(ray.palette());
+		const Graphics g{ fb };
+		std::vector<Frame> frames;
+		frames.reserve(cameras.size());
+		for (const auto& c : cameras) {
+			const auto start = Timer::now();
+			g.clearScreen();
+			if constexpr (Cfg::hasMinimap()) {
+				MiniMap::renderMap(g);
+			}
+			ray.renderView(g, c.x, c.y, c.angle);
+			const auto ms = Timer::millisecondsSince(start);
+			frames.push_back(Frame{ hash(fb), ms });
+		}
+		return frames;
+	}
+
+	//one line per frame: <hash, 16 hex digits> <milliseconds>
+	inline bool save(const std::string& path, const std::vector<Frame>& frames) {
+		std::ofstream out{ path };
+		out << "# frame hash, render ms\n";
+		for (const auto& f : frames) {
+			out << std::hex << std::setw(16) << std::setfill('0') << f.hash << std::dec << " " << f.ms << "\n";
+		}
+		return static_cast<bool>(out);
+	}
+
+	inline bool load(const std::string& path, std::vector<Frame>& frames) {
+		std::ifstream in{ path };
+		std::string line;
+		while (std::getline(in, line)) {
+			if (line.empty() || line[0] == '#') { continue; }
+			std::istringstream fields{ line };
+			Frame f{};
+			if (!(fields >> std::hex >> f.hash >> std::dec >> f.ms)) { return false; }
+			frames.push_back(f);
+		}
+		return in.eof();
+	}
+
+	struct Comparison {
+		size_t mismatches = 0;
+		double golden_p50 = 0.0, golden_p99 = 0.0;
+		double current_p50 = 0.0, current_p99 = 0.0;
+		double slowdown() const noexcept { return (golden_p50 > 0.0) ? current_p50 / golden_p50 - 1.0 : 0.0; } //at p50. Negative is faster.
+	};
+
+	inline Comparison compare(const std::vector<Frame>& golden, const std::vector<Frame>& current, std::ostream& out) {
+		static constexpr size_t MAX_LISTED = 10;
+		Comparison c{};
+		const auto count = std::min(golden.size(), current.size());
+		for (size_t i = 0; i < count; i++) {
+			if (golden[i].hash == current[i].hash) { continue; }
+			if (c.mismatches++ < MAX_LISTED) {
+				out << "  frame " << i << " differs\n";
+			}
+		}
+		if (golden.size() != current.size()) {
+			out << "  frame count differs: golden " << golden.size() << ", current " << current.size() << "\n";
+			c.mismatches += std::max(golden.size(), current.size()) - count;
+		}
+		auto times = [](const std::vector<Frame>& frames) {
+			std::vector<double> ms;
+			for (const auto& f : frames) { ms.push_back(f.ms); }
+			return ms;
+		};
+		auto golden_ms = times(golden);
+		auto current_ms = times(current);
+		c.golden_p99 = Bench::percentile(golden_ms, 0.99);
+		c.golden_p50 = Bench::percentile(golden_ms, 0.50);
+		c.current_p99 = Bench::percentile(current_ms, 0.99);
+		c.current_p50 = Bench::percentile(current_ms, 0.50);
+		return c;
+	}
+}
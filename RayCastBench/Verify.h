@@ -0,0 +1,126 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <vector>
+#include "../RayCastDemo/src/Config.h"
+#include "../RayCastDemo/src/LevelData.h"
+#include "../RayCastDemo/src/RayCaster.h"
+#include "../RayCastDemo/src/Timer.h"
+#include "Bench.h"
+// Differential testing for ray casting kernels. Sweeps a grid of positions over every open cell, casts all ANGLE_360
+// angles from each along both axes, and compares a candidate's RayEnd to the reference within Tolerance.
+// Any faster traversal or table layout should pass this before it replaces the reference.
+namespace Verify {
+	struct Tolerance {
+		float distance_abs = 0.01f; //world units. Either bound is enough to pass.
+		float distance_rel = 1e-4f;
+		int boundary = 0; //cell boundaries are integers and must match exactly
+		int intersection = 1; //truncated from a float, so allow off-by-one
+	};
+
+	struct Options {
+		int step = CELL_SIZE / 8; //grid spacing, in world units
+		Tolerance tolerance{};
+		size_t worst_cases = 8; //how many of the worst mismatches to print
+	};
+
+	enum class Axis { VERTICAL, HORIZONTAL }; //findVerticalWall, findHorizontalWall
+
+	struct Case {
+		int x = 0, y = 0, angle = 0;
+		Axis axis = Axis::VERTICAL;
+		RayEnd expected{};
+		RayEnd actual{};
+		double error = 0.0; //how far outside the tolerance, normalized. > 1 fails.
+	};
+
+	struct Report {
+		uint64_t casts = 0;
+		uint64_t failures = 0;
+		double reference_ms = 0.0;
+		double candidate_ms = 0.0;
+		std::vector<Case> worst; //sorted, worst first
+		bool passed() const noexcept { return failures == 0; }
+	};
+
+	//within tolerance maps to [0, 1), outside it to > 1
+	inline double integerError(int expected, int actual, int tolerance) noexcept {
+		const int diff = std::abs(expected - actual);
+		return (diff <= tolerance) ? diff / (tolerance + 1.0) : 1.0 + diff;
+	}
+
+	//normalized error of one cast. 0 is identical, <= 1 is within tolerance. NaN always fails.
+	inline double error(const RayEnd& expected, const RayEnd& actual, const Tolerance& t) noexcept {
+		const double distance_bound = std::max<double>(t.distance_abs, t.distance_rel * std::fabs(expected.distance));
+		const double distance_error = std::fabs(static_cast<double>(expected.distance) - actual.distance) / distance_bound;
+		if (std::isnan(distance_error)) { return std::numeric_limits<double>::infinity(); }
+		return std::max({ distance_error, integerError(expected.boundary, actual.boundary, t.boundary),
+			integerError(expected.intersection, actual.intersection, t.intersection) });
+	}
+
+	inline void keepWorst(std::vector<Case>& worst, const Case& c, size_t limit) {
+		if (worst.size() == limit && c.error <= worst.back().error) { return; }
+		const auto at = std::upper_bound(worst.begin(), worst.end(), c, [](const Case& a, const Case& b) { return a.error > b.error; });
+		worst.insert(at, c);
+		if (worst.size() > limit) { worst.pop_back(); }
+	}
+
+	//Reference and Candidate must provide findVerticalWall / findHorizontalWall(x, y, angle) -> RayEnd
+	template<typename Reference, typename Candidate>
+	Report compare(const Reference& reference, const Candidate& candidate, const Options& opt) {
+		Report report{};
+		std::vector<RayEnd> expected(ANGLE_360);
+		std::vector<RayEnd> actual(ANGLE_360);
+		uint64_t checksum = 0;
+		auto sweep = [&](auto& kernel, auto search, std::vector<RayEnd>& out, int x, int y) {
+			const auto start = Timer::now();
+			for (int angle = 0; angle < ANGLE_360; angle++) {
+				out[angle] = (kernel.*search)(x, y, angle);
+			}
+			const auto ms = Timer::millisecondsSince(start);
+			checksum += out[0].boundary;
+			return ms;
+		};
+		auto check = [&](Axis axis, int x, int y) {
+			for (int angle = 0; angle < ANGLE_360; angle++) {
+				const double e = error(expected[angle], actual[angle], opt.tolerance);
+				report.casts++;
+				if (e > 1.0) { report.failures++; }
+				if (e > 0.0) { keepWorst(report.worst, Case{ x, y, angle, axis, expected[angle], actual[angle], e }, opt.worst_cases); }
+			}
+		};
+		for (int y = opt.step / 2; y < WORLD_SIZE; y += opt.step) {
+			for (int x = opt.step / 2; x < WORLD_SIZE; x += opt.step) {
+				if (isWall(x >> CELL_SIZE_FP, y >> CELL_SIZE_FP)) { continue; } //the game never casts from inside a wall
+				report.reference_ms += sweep(reference, &Reference::findVerticalWall, expected, x, y);
+				report.candidate_ms += sweep(candidate, &Candidate::findVerticalWall, actual, x, y);
+				check(Axis::VERTICAL, x, y);
+				report.reference_ms += sweep(reference, &Reference::findHorizontalWall, expected, x, y);
+				report.candidate_ms += sweep(candidate, &Candidate::findHorizontalWall, actual, x, y);
+				check(Axis::HORIZONTAL, x, y);
+			}
+		}
+		Bench::consume(checksum);
+		return report;
+	}
+
+	inline void print(std::ostream& out, std::string_view name, const Report& r) {
+		const double speedup = (r.candidate_ms > 0.0) ? r.reference_ms / r.candidate_ms : 0.0;
+		out << (r.passed() ? "PASS " : "FAIL ") << name << ": " << r.casts << " casts, " << r.failures << " outside tolerance. "
+			<< std::fixed << std::setprecision(2) << "reference " << r.reference_ms << " ms, candidate " << r.candidate_ms << " ms ("
+			<< speedup << "x)\n";
+		for (const auto& c : r.worst) {
+			out << "  x:" << c.x << " y:" << c.y << " angle:" << c.angle << ((c.axis == Axis::VERTICAL) ? " vertical" : " horizontal")
+				<< std::setprecision(4) << " | expected " << c.expected.distance << " / " << c.expected.boundary << " / " << c.expected.intersection
+				<< " | actual " << c.actual.distance << " / " << c.actual.boundary << " / " << c.actual.intersection
+				<< std::setprecision(2) << " | error " << c.error << "\n";
+		}
+		out.unsetf(std::ios::floatfield);
+	}
+}
@@ -0,0 +1,802 @@
+#define SDL_MAIN_HANDLED
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "../RayCastDemo/src/Config.h"
+#include "../RayCastDemo/src/LevelData.h"
+#include "../RayCastDemo/src/Graphics.h"
+#include "../RayCastDemo/src/IndexedFrameBuffer.h"
+#include "../RayCastDemo/src/RayCaster.h"
+#include "../RayCastDemo/src/GridTraversal.h"
+#include "../RayCastDemo/src/FlowField.h"
+#include "../RayCastDemo/src/Pathfinding.h"
+#include "../RayCastDemo/src/HierarchicalPathfinder.h"
+#include "../RayCastDemo/src/Entities.h"
+#include "../RayCastDemo/src/Broadphase.h"
+#include "../RayCastDemo/src/JobPool.h"
+#include "../RayCastDemo/src/Pool.h"
+#include "../RayCastDemo/src/Projectile.h"
+#include "Bench.h"
+#include "CameraPaths.h"
+#include "Verify.h"
+#include "Replay.h"
+#include "PVSBuilder.h"
+#include "Mazes.h"
+// Windowless benchmark for the ray casting kernels. Renders into a headless IndexedFrameBuffer, so there is no GPU or
+// present() in the numbers. Build Release, run from a console:
+//   RayCastBench [bench] [--warmup N] [--reps N]   time the kernels
+//   RayCastBench verify [--step N]                 compare candidate kernels against RayCaster, see Verify.h
+//   RayCastBench replay <track> [--save F] [--golden F] [--max-slowdown PCT]
+//                                                  render an ActionTrack headless, save or check frame hashes and timings
+//   RayCastBench pvs [--samples N] [--out F]       build the potentially visible sets, written as a header (LevelPVS.h)
+namespace {
+	static constexpr int WALK_TICKS = 600; //ten seconds of game time
+
+	//cast the full field of view from every camera, with one of the two wall searches
+	template<typename Caster, typename Search>
+	uint64_t castAll(const Caster& ray, const std::vector<Camera>& cameras, Search search) noexcept {
+		uint64_t checksum = 0;
+		for (const auto& c : cameras) {
+			int angle = c.angle - HALF_FOV_ANGLE;
+			if (angle < 0) { angle += ANGLE_360; }
+			for (int column = 0; column < RAY_COUNT; column++) {
+				const RayEnd hit = (ray.*search)(c.x, c.y, angle);
+				checksum += static_cast<uint64_t>(hit.boundary) + hit.intersection;
+				if (++angle >= ANGLE_360) { angle -= ANGLE_360; }
+			}
+		}
+		return checksum;
+	}
+
+	template<typename Caster>
+	void benchMap(std::string_view map, const Bench::Options& opt, const std::vector<Camera>& poses, const std::vector<Camera>& walk) {
+		const Caster ray{};
+		IndexedFrameBuffer fb{ Cfg::WIN_WIDTH, Cfg::WIN_HEIGHT }; //no renderer: headless
+		fb.setPalette(ray.palette());
+		const Graphics g{ fb };
+		const auto pose_rays = static_cast<uint64_t>(poses.size()) * RAY_COUNT;
+		const auto walk_rays = static_cast<uint64_t>(walk.size()) * RAY_COUNT;
+
+		Bench::print(std::cout, Bench::run("findVerticalWall", map, opt, pose_rays, [&] {
+			Bench::consume(castAll(ray, poses, &Caster::findVerticalWall));
+		}));
+		Bench::print(std::cout, Bench::run("findHorizontalWall", map, opt, pose_rays, [&] {
+			Bench::consume(castAll(ray, poses, &Caster::findHorizontalWall));
+		}));
+		Bench::print(std::cout, Bench::run("renderView (poses)", map, opt, pose_rays, [&] {
+			for (const auto& c : poses) {
+				ray.renderView(g, c.x, c.y, c.angle);
+			}
+			Bench::consume(fb.data()[VIEWPORT_HORIZON * fb.width()]);
+		}));
+		Bench::print(std::cout, Bench::run("renderView (walk)", map, opt, walk_rays, [&] {
+			for (const auto& c : walk) {
+				ray.renderView(g, c.x, c.y, c.angle);
+			}
+			Bench::consume(fb.data()[VIEWPORT_HORIZON * fb.width()]);
+		}));
+		const auto expand = std::string("expandToRGBA (") + fb.expandKernel() + ")";
+		Bench::print(std::cout, Bench::run(expand, map, opt, static_cast<uint64_t>(fb.width()) * fb.height(), [&] {
+			Bench::consume(fb.expandToRGBA()[VIEWPORT_HORIZON * fb.width()]);
+		}));
+	}
+
+	//present()'s expansion with the shaded palette, and with only the base colors as without distance shading, which
+	//takes the pshufb kernel where it is compiled in. Either must turn every index into exactly its palette color.
+	bool benchExpand(const Bench::Options& opt) {
+		IndexedFrameBuffer fb{ Cfg::WIN_WIDTH, Cfg::WIN_HEIGHT };
+		const ColorMap shades{};
+		const auto pixels = static_cast<size_t>(fb.width()) * fb.height();
+		std::mt19937 rng(15);
+		bool passed = true;
+		for (const auto colors : { shades.palette(), shades.palette().first(PALETTE_SIZE) }) {
+			fb.setPalette(colors);
+			for (size_t i = 0; i < pixels; i++) {
+				fb.data()[i] = static_cast<IndexedFrameBuffer::PaletteIndex>(rng() % colors.size());
+			}
+			const auto name = std::string("expandToRGBA (") + fb.expandKernel() + ")";
+			Bench::print(std::cout, Bench::run(name, std::to_string(colors.size()) + " colors", opt, pixels, [&] {
+				Bench::consume(fb.expandToRGBA()[VIEWPORT_HORIZON * fb.width()]);
+			}));
+			const Uint32* rgba = fb.expandToRGBA();
+			size_t wrong = 0;
+			for (size_t i = 0; i < pixels; i++) {
+				const auto& c = colors[fb.data()[i]];
+				wrong += rgba[i] != ((0xFFu << 24) | (Uint32{ c.r } << 16) | (Uint32{ c.g } << 8) | Uint32{ c.b });
+			}
+			if (wrong > 0) {
+				std::cout << name << ": " << wrong << " pixels expanded to the wrong color\n";
+				passed = false;
+			}
+		}
+		return passed;
+	}
+
+	//a random track must come back from format() and parse() tick for tick: replays depend on it
+	bool checkActionTrack() {
+		std::mt19937 rng(12);
+		std::vector<Actions> track{ Actions{ Actions::FIRE, true, 3, 7 } }; //a click to teleport while holding fire
+		for (int i = 0; i < 10000; i++) {
+			Actions a{ static_cast<uint8_t>(rng() % 32) };
+			if (rng() % 8 == 0) {
+				a.teleport = true;
+				a.teleportCellX = static_cast<int8_t>(rng() % WORLD_COLUMNS);
+				a.teleportCellY = static_cast<int8_t>(rng() % WORLD_ROWS);
+			}
+			track.insert(track.end(), 1 + rng() % 4, a);
+		}
+		std::vector<Actions> parsed;
+		std::string error;
+		if (!ActionTrack::parse(ActionTrack::format(track), parsed, error) || parsed != track) {
+			std::cout << "ActionTrack: format() and parse() don't round-trip" << (error.empty() ? "" : ", bad token '" + error + "'") << "\n";
+			return false;
+		}
+		return true;
+	}
+
+	//every pose looks at a spread of other poses: a mix of short, long, clear and blocked segments
+	std::vector<GridTraversal::Query> sightLines(const std::vector<Camera>& poses) {
+		static constexpr size_t TARGETS = 16;
+		std::vector<GridTraversal::Query> queries;
+		queries.reserve(poses.size() * TARGETS);
+		for (size_t i = 0; i < poses.size(); i++) {
+			for (size_t t = 1; t <= TARGETS; t++) {
+				const auto& target = poses[(i + t * 7919) % poses.size()];
+				queries.push_back({ poses[i].x, poses[i].y, target.x, target.y });
+			}
+		}
+		return queries;
+	}
+
+	template<auto IsWall>
+	bool benchLineOfSight(std::string_view map, const Bench::Options& opt, const std::vector<GridTraversal::Query>& queries) {
+		static constexpr auto rows = GridTraversal::wallRows<IsWall>();
+		std::vector<uint64_t> visible((queries.size() + 63) / 64);
+		Bench::print(std::cout, Bench::run("isClear", map, opt, queries.size(), [&] {
+			uint64_t clear = 0;
+			for (const auto& q : queries) {
+				clear += GridTraversal::isClear(rows, q);
+			}
+			Bench::consume(clear);
+		}));
+		const auto batch = std::string("lineOfSight (") + GridTraversal::lineOfSightKernel() + ")";
+		Bench::print(std::cout, Bench::run(batch, map, opt, queries.size(), [&] {
+			GridTraversal::lineOfSight<IsWall>(queries, visible);
+			Bench::consume(visible[0]);
+		}));
+		size_t wrong = 0; //the batch must agree with isClear, query for query
+		for (size_t i = 0; i < queries.size(); i++) {
+			wrong += GridTraversal::isVisible(visible, i) != GridTraversal::isClear(rows, queries[i]);
+		}
+		if (wrong > 0) {
+			std::cout << batch << ": " << wrong << " queries disagree with isClear\n";
+		}
+		return wrong == 0;
+	}
+
+	//random edits patched into a few cached fields must leave each exactly as a fresh build would: the same distance and
+	//step in every cell
+	bool checkFlowFieldEdits() {
+		static constexpr int EDITS = 20000;
+		static constexpr int GOALS = 4;
+		auto grid = OccupancyGrid::fromLevel<isWall>();
+		FlowFieldCache<GOALS> cache{ grid };
+		std::mt19937 rng(14);
+		auto randomCell = [&] { return FIRST_VALID_CELL + static_cast<int>(rng() % (LAST_VALID_CELL - FIRST_VALID_CELL + 1)); };
+		std::array<std::pair<int, int>, GOALS> goals;
+		for (auto& [x, y] : goals) {
+			x = randomCell();
+			y = randomCell();
+			cache.field(x, y);
+		}
+		FlowField fresh;
+		int wrong = 0;
+		for (int e = 0; e < EDITS; e++) {
+			const int x = randomCell(), y = randomCell();
+			cache.setWall(x, y, rng() % 10 < 3); //settles at about a third walls
+			for (const auto& [goal_x, goal_y] : goals) {
+				const FlowField& patched = cache.field(goal_x, goal_y);
+				fresh.build(grid, goal_x, goal_y);
+				bool same = true;
+				for (int cy = 0; cy < WORLD_ROWS; cy++) {
+					for (int cx = 0; cx < WORLD_COLUMNS; cx++) {
+						const auto a = patched.step(cx, cy), b = fresh.step(cx, cy);
+						same &= patched.distance(cx, cy) == fresh.distance(cx, cy) && a.dx == b.dx && a.dy == b.dy;
+					}
+				}
+				wrong += !same;
+			}
+		}
+		if (wrong > 0) {
+			std::cout << "FlowFieldCache: " << wrong << " fields differ from a fresh build after an edit\n";
+		}
+		return wrong == 0;
+	}
+
+	//a full build towards every open cell, then map edits patched into a few cached fields
+	void benchFlowField(std::string_view map, const Bench::Options& opt) {
+		static constexpr int EDITED_ROW = 7; //an open corridor: every edit changes paths
+		auto grid = OccupancyGrid::fromLevel<isWall>();
+		int open_cells = 0;
+		for (int y = 0; y < WORLD_ROWS; y++) {
+			for (int x = 0; x < WORLD_COLUMNS; x++) {
+				open_cells += !grid.isWall(x, y);
+			}
+		}
+		FlowField field;
+		Bench::print(std::cout, Bench::run("FlowField::build", map, opt, open_cells, [&] {
+			int total = 0;
+			for (int y = 0; y < WORLD_ROWS; y++) {
+				for (int x = 0; x < WORLD_COLUMNS; x++) {
+					if (grid.isWall(x, y)) { continue; }
+					field.build(grid, x, y);
+					total += field.distance(FIRST_VALID_CELL, FIRST_VALID_CELL);
+				}
+			}
+			Bench::consume(total);
+		}));
+		FlowFieldCache<4> cache{ grid };
+		cache.field(FIRST_VALID_CELL, FIRST_VALID_CELL);
+		cache.field(LAST_VALID_CELL, LAST_VALID_CELL);
+		cache.field(FIRST_VALID_CELL, LAST_VALID_CELL);
+		cache.field(LAST_VALID_CELL, FIRST_VALID_CELL);
+		const int edits = 2 * (LAST_VALID_CELL - FIRST_VALID_CELL + 1);
+		Bench::print(std::cout, Bench::run("FlowFieldCache::setWall", map, opt, edits, [&] {
+			for (int x = FIRST_VALID_CELL; x <= LAST_VALID_CELL; x++) {
+				cache.setWall(x, EDITED_ROW, true);
+				cache.setWall(x, EDITED_ROW, false);
+			}
+			Bench::consume(cache.field(FIRST_VALID_CELL, FIRST_VALID_CELL).distance(LAST_VALID_CELL, LAST_VALID_CELL));
+		}));
+	}
+
+	//does path walk from start to goal in straight or diagonal lines, through open cells, never cutting a corner?
+	bool walkable(const BitGrid& grid, const std::vector<Pathfinding::Point>& path, Pathfinding::Point start, Pathfinding::Point goal) {
+		if (path.empty() || path.front() != start || path.back() != goal) { return false; }
+		for (size_t i = 1; i < path.size(); i++) {
+			const int dx = path[i].x - path[i - 1].x, dy = path[i].y - path[i - 1].y;
+			if (dx != 0 && dy != 0 && std::abs(dx) != std::abs(dy)) { return false; }
+			const int steps = std::max(std::abs(dx), std::abs(dy));
+			for (Pathfinding::Point p = path[i - 1]; p != path[i]; p = { p.x + dx / steps, p.y + dy / steps }) {
+				if (!Pathfinding::canStep(grid, p, dx / steps, dy / steps)) { return false; }
+			}
+		}
+		return true;
+	}
+
+	//A* and JPS on small random grids, some of them a word and a bit wide: they must find the same costs, along paths
+	//that are really there
+	bool checkPathfinding() {
+		static constexpr int GRIDS = 3000;
+		std::mt19937 rng(13);
+		GridAStar astar;
+		JumpPointSearch jps;
+		std::vector<Pathfinding::Point> astar_path, jps_path;
+		int wrong = 0;
+		for (int i = 0; i < GRIDS; i++) {
+			const int width = 1 + static_cast<int>(rng() % 150), height = 1 + static_cast<int>(rng() % 150);
+			auto grid = Mazes::scattered(width, height, static_cast<float>(rng() % 40) / 100.0f, rng());
+			const Pathfinding::Point start{ static_cast<int>(rng() % width), static_cast<int>(rng() % height) };
+			const Pathfinding::Point goal{ static_cast<int>(rng() % width), static_cast<int>(rng() % height) };
+			grid.setOpen(start.x, start.y, true);
+			grid.setOpen(goal.x, goal.y, true);
+			const bool found = astar.find(grid, start, goal, astar_path);
+			if (found != jps.find(grid, start, goal, jps_path)
+				|| (found && (!walkable(grid, astar_path, start, goal) || !walkable(grid, jps_path, start, goal)
+					|| std::abs(Pathfinding::pathCost(astar_path) - Pathfinding::pathCost(jps_path)) > 0.01f))) {
+				wrong++;
+			}
+		}
+		if (wrong > 0) {
+			std::cout << "GridAStar / JumpPointSearch: " << wrong << " of " << GRIDS << " random grids disagree or walk through walls\n";
+		}
+		return wrong == 0;
+	}
+
+	//A* and JPS race on the same queries. Both are optimal, so their path costs must agree.
+	bool benchPathfinding(std::string_view map, const Bench::Options& opt, const BitGrid& grid, int count) {
+		const auto queries = Mazes::queries(grid, count, 7);
+		GridAStar astar;
+		JumpPointSearch jps;
+		std::vector<Pathfinding::Point> path;
+		std::vector<float> costs;
+		uint64_t astar_expanded = 0, jps_expanded = 0;
+		bool passed = true;
+		for (const auto& [start, goal] : queries) {
+			astar.find(grid, start, goal, path);
+			costs.push_back(Pathfinding::pathCost(path));
+			astar_expanded += astar.expanded();
+			jps.find(grid, start, goal, path);
+			jps_expanded += jps.expanded();
+			if (std::abs(Pathfinding::pathCost(path) - costs.back()) > 0.01f) {
+				std::cout << "JumpPointSearch: path cost " << Pathfinding::pathCost(path) << " differs from A* " << costs.back() << "\n";
+				passed = false;
+			}
+		}
+		Bench::print(std::cout, Bench::run("GridAStar", map, opt, count, [&] {
+			for (const auto& [start, goal] : queries) {
+				astar.find(grid, start, goal, path);
+			}
+			Bench::consume(path.size());
+		}));
+		Bench::print(std::cout, Bench::run("JumpPointSearch", map, opt, count, [&] {
+			for (const auto& [start, goal] : queries) {
+				jps.find(grid, start, goal, path);
+			}
+			Bench::consume(path.size());
+		}));
+		std::cout << "  nodes expanded per query: A* " << astar_expanded / count << ", JPS " << jps_expanded / count << "\n";
+		return passed;
+	}
+
+	//HPA* on maps too big to search cell by cell. Its paths run through entrance cells and its search is weighted, so they
+	//can be a little longer than optimal: checked against JPS and against its own search at weight 1, outside the timings.
+	bool benchHierarchical(std::string_view map, const Bench::Options& opt, BitGrid grid, int count) {
+		const auto queries = Mazes::queries(grid, count, 11);
+		const auto start = Timer::now();
+		HierarchicalPathfinder hpa{ grid };
+		const auto build_ms = Timer::millisecondsSince(start);
+		const float weight = hpa.weight();
+		JumpPointSearch jps;
+		std::vector<Pathfinding::Point> path, waypoints, cells;
+		double excess = 0.0, exact_excess = 0.0, jps_ms = 0.0;
+		std::vector<float> costs; //at weight 1
+		bool passed = true;
+		for (const auto& [from, to] : queries) {
+			const auto jps_start = Timer::now();
+			const bool found = jps.find(grid, from, to, path);
+			jps_ms += Timer::millisecondsSince(jps_start);
+			hpa.setWeight(1.0f);
+			const bool hpa_found = hpa.findPath(from, to, waypoints, cells);
+			hpa.setWeight(weight);
+			costs.push_back(hpa_found ? Pathfinding::pathCost(cells) : -1.0f);
+			if (found != hpa_found) {
+				std::cout << "HierarchicalPathfinder: disagrees with JPS on whether a path exists\n";
+				passed = false;
+				continue;
+			}
+			if (!found) { continue; }
+			const auto optimal = Pathfinding::pathCost(path);
+			if (costs.back() < optimal - 0.01f) {
+				std::cout << "HierarchicalPathfinder: path cost " << costs.back() << " beats the optimum " << optimal << "\n";
+				passed = false;
+			}
+			hpa.findPath(from, to, waypoints, cells);
+			const auto weighted = Pathfinding::pathCost(cells);
+			if (weighted > weight * costs.back() + 0.01f) {
+				std::cout << "HierarchicalPathfinder: path cost " << weighted << " is over " << weight << " times " << costs.back() << "\n";
+				passed = false;
+			}
+			excess += (optimal > 0.0f) ? weighted / optimal - 1.0 : 0.0;
+			exact_excess += (optimal > 0.0f) ? costs.back() / optimal - 1.0 : 0.0;
+		}
+		Bench::print(std::cout, Bench::run("HPA* find", map, opt, count, [&] {
+			for (const auto& [from, to] : queries) {
+				hpa.find(from, to, waypoints);
+			}
+			Bench::consume(waypoints.size());
+		}));
+		Bench::print(std::cout, Bench::run("HPA* find + refine", map, opt, count, [&] {
+			for (const auto& [from, to] : queries) {
+				hpa.findPath(from, to, waypoints, cells);
+			}
+			Bench::consume(cells.size());
+		}));
+		hpa.setWeight(1.0f);
+		Bench::print(std::cout, Bench::run("HPA* find, weight 1", map, opt, count, [&] {
+			for (const auto& [from, to] : queries) {
+				hpa.find(from, to, waypoints);
+			}
+			Bench::consume(waypoints.size());
+		}));
+		const auto edited = queries.front().first;
+		Bench::print(std::cout, Bench::run("HPA* setOpen + update", map, opt, 2, [&] {
+			hpa.setOpen(edited.x, edited.y, false);
+			hpa.update();
+			hpa.setOpen(edited.x, edited.y, true);
+			hpa.update();
+		}));
+		//the edited cluster's region is stale now: it is crossed entrance by entrance, which must find the same paths at weight 1
+		for (size_t i = 0; i < queries.size(); i++) {
+			const bool found = hpa.findPath(queries[i].first, queries[i].second, waypoints, cells);
+			if (std::abs((found ? Pathfinding::pathCost(cells) : -1.0f) - costs[i]) > 0.01f) {
+				std::cout << "HierarchicalPathfinder: a stale region changed a path\n";
+				passed = false;
+			}
+		}
+		hpa.setWeight(weight);
+		Bench::print(std::cout, Bench::run("HPA* setOpen + rebuildRegions", map, opt, 2, [&] {
+			hpa.setOpen(edited.x, edited.y, false);
+			hpa.rebuildRegions();
+			hpa.setOpen(edited.x, edited.y, true);
+			hpa.rebuildRegions();
+		}));
+		std::cout << "  build " << static_cast<int>(build_ms) << " ms, JPS " << jps_ms / count << " ms per query, HPA* paths "
+			<< 100.0 * excess / count << "% longer than optimal at weight " << weight << ", " << 100.0 * exact_excess / count << "% at 1\n";
+		return passed;
+	}
+
+	//does an actor's square (see Movement::sweep) overlap a wall?
+	bool overlapsWall(int x, int y) noexcept {
+		static constexpr int r = Cfg::COLLISION_RADIUS;
+		return isWall((x - r) / CELL_SIZE, (y - r) / CELL_SIZE) || isWall((x + r - 1) / CELL_SIZE, (y - r) / CELL_SIZE)
+			|| isWall((x - r) / CELL_SIZE, (y + r - 1) / CELL_SIZE) || isWall((x + r - 1) / CELL_SIZE, (y + r - 1) / CELL_SIZE);
+	}
+
+	//count actors clear of the walls, walking every way at up to max_speed times WALK_SPEED, so every collision case
+	//gets exercised. Above CELL_SIZE / WALK_SPEED they cover more than a cell per tick.
+	EntityStore spawnEntities(size_t count, float max_speed) {
+		EntityStore store{ count };
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> speed(-max_speed, max_speed);
+		while (store.size() < count) {
+			const int x = static_cast<int>(rng() % (WORLD_COLUMNS * CELL_SIZE));
+			const int y = static_cast<int>(rng() % (WORLD_ROWS * CELL_SIZE));
+			if (overlapsWall(x, y)) { continue; }
+			const auto i = store.add(x, y, static_cast<int>(rng() % ANGLE_360));
+			store.setIntent(i, static_cast<int>(rng() % 33) - 16, speed(rng));
+		}
+		return store;
+	}
+
+	//the SoA tick: scalar reference, AVX2 (when compiled in) on one thread, then spread over a JobPool.
+	//The three must agree exactly, checked over a few hundred ticks first. With swept collision, no actor may end up
+	//in a wall, however fast it goes.
+	bool benchEntities(std::string_view map, const Bench::Options& opt, size_t count, float max_speed) {
+		static constexpr auto walls = GridTraversal::wallRows<isWall>();
+		static constexpr int CHECKED_TICKS = 300;
+		JobPool jobs{};
+		auto reference = spawnEntities(count, max_speed);
+		auto single = spawnEntities(count, max_speed);
+		auto parallel = spawnEntities(count, max_speed);
+		for (int t = 0; t < CHECKED_TICKS; t++) {
+			reference.tickScalar(walls);
+			single.tick(walls);
+			parallel.tick(walls, &jobs);
+		}
+		auto same = [&](const EntityStore& a) {
+			return std::ranges::equal(a.xs(), reference.xs()) && std::ranges::equal(a.ys(), reference.ys()) && std::ranges::equal(a.angles(), reference.angles());
+		};
+		bool passed = true;
+		if (!same(single) || !same(parallel)) {
+			std::cout << "EntityStore: tick() drifted from tickScalar() within " << CHECKED_TICKS << " ticks\n";
+			passed = false;
+		}
+		if constexpr (Cfg::hasSweptCollision()) { //every path sweeps its own way: the scalar one, and the SIMD one when compiled in
+			auto stuck = [&](const EntityStore& store, std::string_view path) {
+				size_t in_wall = 0;
+				for (size_t i = 0; i < count; i++) {
+					in_wall += overlapsWall(store.x(i), store.y(i));
+				}
+				if (in_wall > 0) {
+					std::cout << "EntityStore: " << in_wall << " actors ended up in a wall (" << path << ")\n";
+					passed = false;
+				}
+			};
+			stuck(reference, "tickScalar");
+			stuck(single, EntityStore::kernel());
+			stuck(parallel, "parallel");
+		}
+		Bench::print(std::cout, Bench::run("EntityStore::tickScalar", map, opt, count, [&] {
+			reference.tickScalar(walls);
+			Bench::consume(reference.x(0));
+		}));
+		Bench::print(std::cout, Bench::run(std::string("EntityStore::tick (") + EntityStore::kernel() + ")", map, opt, count, [&] {
+			single.tick(walls);
+			Bench::consume(single.x(0));
+		}));
+		const auto name = std::string("EntityStore::tick (") + EntityStore::kernel() + ", " + std::to_string(jobs.threads()) + " thr)";
+		Bench::print(std::cout, Bench::run(name, map, opt, count, [&] {
+			parallel.tick(walls, &jobs);
+			Bench::consume(parallel.x(0));
+		}));
+		return passed;
+	}
+
+	bool benchBroadphase(std::string_view map, const Bench::Options& opt, size_t count) {
+		static constexpr auto walls = GridTraversal::wallRows<isWall>();
+		static constexpr int RADIUS = CELL_SIZE / 2;
+		static constexpr size_t CHECKED_QUERIES = 500;
+		static constexpr size_t CHECKED_PAIRS = 4000; //brute force is quadratic: check pairs on the first few actors
+		static constexpr size_t BRUTE_QUERIES = 64;
+		JobPool jobs{};
+		auto actors = spawnEntities(count, 1.0f);
+		for (int t = 0; t < 100; t++) { actors.tick(walls, &jobs); } //spread out from the cell centers
+		const auto xs = actors.xs();
+		const auto ys = actors.ys();
+		auto near = [&](size_t a, int x, int y) {
+			const int64_t dx = xs[a] - x;
+			const int64_t dy = ys[a] - y;
+			return dx * dx + dy * dy <= int64_t{ RADIUS } * RADIUS;
+		};
+		Broadphase single{ count };
+		Broadphase parallel{ count };
+		single.rebuild(xs, ys);
+		parallel.rebuild(xs, ys, &jobs);
+		bool ok = true;
+		for (int y = 0; y < Broadphase::ROWS; y++) {
+			for (int x = 0; x < Broadphase::COLUMNS; x++) {
+				ok &= std::ranges::equal(single.inCell(x, y), parallel.inCell(x, y));
+			}
+		}
+		std::vector<uint32_t> found, expected;
+		for (size_t q = 0; q < CHECKED_QUERIES; q++) {
+			const size_t i = q * count / CHECKED_QUERIES;
+			found.clear();
+			expected.clear();
+			parallel.forEachInRadius(xs[i], ys[i], RADIUS, [&](uint32_t a) { found.push_back(a); });
+			for (size_t a = 0; a < count; a++) {
+				if (near(a, xs[i], ys[i])) { expected.push_back(static_cast<uint32_t>(a)); }
+			}
+			std::ranges::sort(found);
+			ok &= found == expected;
+		}
+		Broadphase few{ CHECKED_PAIRS };
+		few.rebuild(xs.first(CHECKED_PAIRS), ys.first(CHECKED_PAIRS));
+		uint64_t pairs = 0, pair_sum = 0, brute_pairs = 0, brute_sum = 0;
+		few.forEachPair(RADIUS, [&](uint32_t a, uint32_t b) { pairs++; pair_sum += uint64_t{ std::min(a, b) } * CHECKED_PAIRS + std::max(a, b); });
+		for (size_t a = 0; a < CHECKED_PAIRS; a++) {
+			for (size_t b = a + 1; b < CHECKED_PAIRS; b++) {
+				if (near(b, xs[a], ys[a])) { brute_pairs++; brute_sum += a * CHECKED_PAIRS + b; }
+			}
+		}
+		ok &= pairs == brute_pairs && pair_sum == brute_sum;
+		if (!ok) {
+			std::cout << "Broadphase: rebuild or queries disagree with brute force\n";
+		}
+		Bench::print(std::cout, Bench::run("Broadphase::rebuild", map, opt, count, [&] {
+			single.rebuild(xs, ys);
+			Bench::consume(single.size());
+		}));
+		const auto name = "Broadphase::rebuild (" + std::to_string(jobs.threads()) + " thr)";
+		Bench::print(std::cout, Bench::run(name, map, opt, count, [&] {
+			parallel.rebuild(xs, ys, &jobs);
+			Bench::consume(parallel.size());
+		}));
+		Bench::print(std::cout, Bench::run("Broadphase::forEachInRadius", map, opt, count, [&] {
+			size_t hits = 0;
+			for (size_t i = 0; i < count; i++) {
+				parallel.forEachInRadius(xs[i], ys[i], RADIUS, [&](uint32_t) { hits++; });
+			}
+			Bench::consume(hits);
+		}));
+		Bench::print(std::cout, Bench::run("brute-force radius", map, opt, BRUTE_QUERIES, [&] {
+			size_t hits = 0;
+			for (size_t q = 0; q < BRUTE_QUERIES; q++) {
+				const size_t i = q * count / BRUTE_QUERIES;
+				for (size_t a = 0; a < count; a++) { hits += near(a, xs[i], ys[i]); }
+			}
+			Bench::consume(hits);
+		}));
+		return ok;
+	}
+
+	//keeps count shots in flight from random open cells: every pass moves them all, and replaces the ones that hit a wall
+	bool benchPool(std::string_view map, const Bench::Options& opt, size_t count) {
+		std::vector<Projectile> shots;
+		std::mt19937 rng(5);
+		while (shots.size() < count * 4) {
+			const int x = static_cast<int>(rng() % WORLD_COLUMNS);
+			const int y = static_cast<int>(rng() % WORLD_ROWS);
+			if (isWall(x, y)) { continue; }
+			shots.push_back(Projectile::fire(x * CELL_SIZE + (CELL_SIZE >> 1), y * CELL_SIZE + (CELL_SIZE >> 1), static_cast<int>(rng() % ANGLE_360)));
+		}
+		Pool<Projectile> pool{ count };
+		std::vector<std::unique_ptr<Projectile>> heap; //one allocation per object: what the pool replaces
+		size_t next_pool = 0, next_heap = 0;
+		auto tickPool = [&] {
+			pool.removeIf([](Projectile& p) { return !p.update(isWall); });
+			while (!pool.full()) { pool.create(shots[next_pool++ % shots.size()]); }
+		};
+		auto tickHeap = [&] {
+			std::erase_if(heap, [](const std::unique_ptr<Projectile>& p) { return !p->update(isWall); });
+			while (heap.size() < count) { heap.push_back(std::make_unique<Projectile>(shots[next_heap++ % shots.size()])); }
+		};
+		for (int t = 0; t < 200; t++) {
+			tickPool();
+			tickHeap();
+		}
+		bool passed = true;
+		if (next_pool != next_heap) {
+			std::cout << "Pool: " << next_pool << " shots fired, but " << next_heap << " from the heap\n";
+			passed = false;
+		}
+		Handle stale = pool.handleAt(0);
+		pool.destroy(stale);
+		pool.create(shots[0]);
+		if (pool.contains(stale) || pool.get(stale) != nullptr) {
+			std::cout << "Pool: a destroyed object's handle still resolves after its slot was reused\n";
+			passed = false;
+		}
+		Bench::print(std::cout, Bench::run("Pool<Projectile> tick", map, opt, count, [&] {
+			tickPool();
+			Bench::consume(pool.items()[0].x);
+		}));
+		Bench::print(std::cout, Bench::run("unique_ptr<Projectile> tick", map, opt, count, [&] {
+			tickHeap();
+			Bench::consume(heap[0]->x);
+		}));
+		return passed;
+	}
+
+	bool parseInt(std::string_view text, int& out) noexcept {
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), out);
+		return error == std::errc{} && end == text.data() + text.size() && out >= 0;
+	}
+
+	template<typename Candidate>
+	bool verifyCandidate(std::string_view name, const RayCaster& reference, const Verify::Options& opt) {
+		const Candidate candidate{};
+		const auto report = Verify::compare(reference, candidate, opt);
+		Verify::print(std::cout, name, report);
+		return report.passed();
+	}
+
+	//add new kernels here. Comparing the reference against itself sets the timing noise floor.
+	int verify(const Verify::Options& opt) {
+		const RayCaster reference{};
+		std::cout << "sweeping every " << opt.step << " world units, " << ANGLE_360 << " angles, both axes.\n";
+		bool passed = true;
+		passed &= verifyCandidate<RayCaster>("RayCaster (self)", reference, opt);
+		passed &= verifyCandidate<BasicRayCaster<LevelBitmap::isWall>>("BasicRayCaster<LevelBitmap::isWall>", reference, opt);
+		passed &= verifyCandidate<BasicRayCaster<LevelChars::isWall>>("BasicRayCaster<LevelChars::isWall>", reference, opt);
+		return passed ? 0 : 1;
+	}
+
+	int bench(const Bench::Options& opt) {
+		const auto poses = CameraPaths::poses();
+		const auto walk = CameraPaths::walk(WALK_TICKS);
+		std::cout << poses.size() << " poses, " << walk.size() << " walk frames, " << RAY_COUNT << " rays each. "
+			<< opt.warmup << " warmup / " << opt.repetitions << " timed passes per case.\n\n";
+		//the self-checks run alongside the timings: any failure fails the run
+		bool passed = true;
+		passed &= checkActionTrack();
+		passed &= checkPathfinding();
+		passed &= checkFlowFieldEdits();
+		Bench::printHeader(std::cout);
+		benchMap<BasicRayCaster<LevelBitmap::isWall>>("bitmap", opt, poses, walk);
+		benchMap<BasicRayCaster<LevelChars::isWall>>("chars", opt, poses, walk);
+		passed &= benchExpand(opt);
+		const auto queries = sightLines(poses);
+		passed &= benchLineOfSight<LevelBitmap::isWall>("bitmap", opt, queries);
+		benchFlowField("bitmap", opt);
+		passed &= benchPathfinding("level", opt, BitGrid::fromLevel<isWall>(), 64);
+		passed &= benchPathfinding("maze 255", opt, Mazes::maze(127, 0.1f, 1), 16);
+		passed &= benchPathfinding("maze 511", opt, Mazes::maze(255, 0.1f, 2), 4);
+		passed &= benchPathfinding("scatter 512", opt, Mazes::scattered(512, 512, 0.2f, 3), 4);
+		passed &= benchEntities("100k", opt, 100000, 1.0f);
+		passed &= benchEntities("100k fast", opt, 100000, 24.0f);
+		passed &= benchBroadphase("100k", opt, 100000);
+		passed &= benchPool("bitmap", opt, 4096);
+		passed &= benchHierarchical("rooms 1024", opt, Mazes::rooms(1024, 1024, 4), 8);
+		passed &= benchHierarchical("rooms 2048", opt, Mazes::rooms(2048, 2048, 5), 4);
+		passed &= benchHierarchical("rooms 4096", opt, Mazes::rooms(4096, 4096, 8), 4);
+		passed &= benchHierarchical("maze 1023", opt, Mazes::maze(511, 0.1f, 6), 4);
+		passed &= benchHierarchical("scatter 1024", opt, Mazes::scattered(1024, 1024, 0.2f, 7), 4);
+		if (!passed) {
+			std::cout << "\nself-checks failed, see above\n";
+		}
+		return passed ? 0 : 1;
+	}
+
+	struct ReplayOptions {
+		std::string track;
+		std::string save; //write this run's frames here
+		std::string golden; //compare this run against these frames
+		int max_slowdown = -1; //percent, at p50. Negative: report timings, but never fail on them.
+	};
+
+	int replay(const ReplayOptions& opt) {
+		std::ifstream in{ opt.track };
+		if (!in) {
+			std::cerr << "can't read track: " << opt.track << "\n";
+			return 1;
+		}
+		std::stringstream text;
+		text << in.rdbuf();
+		std::vector<Actions> track;
+		std::string error;
+		if (!ActionTrack::parse(text.str(), track, error)) {
+			std::cerr << opt.track << ": bad token '" << error << "'\n";
+			return 1;
+		}
+		const auto frames = Replay::run(CameraPaths::replay(track));
+		std::cout << "rendered " << frames.size() << " frames\n";
+		if (!opt.save.empty() && !Replay::save(opt.save, frames)) {
+			std::cerr << "can't write: " << opt.save << "\n";
+			return 1;
+		}
+		if (opt.golden.empty()) {
+			return 0;
+		}
+		std::vector<Replay::Frame> golden;
+		if (!Replay::load(opt.golden, golden)) {
+			std::cerr << "can't read golden frames: " << opt.golden << "\n";
+			return 1;
+		}
+		const auto c = Replay::compare(golden, frames, std::cout);
+		std::cout << std::fixed << std::setprecision(3) << c.mismatches << " frames differ from " << opt.golden << ".\n"
+			<< "render ms p50/p99: golden " << c.golden_p50 << " / " << c.golden_p99 << ", current " << c.current_p50 << " / " << c.current_p99
+			<< std::setprecision(1) << " (" << (c.slowdown() * 100.0) << "% at p50)\n";
+		const bool too_slow = (opt.max_slowdown >= 0 && c.slowdown() * 100.0 > opt.max_slowdown);
+		return (c.mismatches == 0 && !too_slow) ? 0 : 1;
+	}
+
+	struct PVSOptions {
+		PVSBuilder::Options build{};
+		std::string out; //stdout if empty
+	};
+
+	int pvs(const PVSOptions& opt) {
+		const RayCaster ray{};
+		const auto visible = PVSBuilder::build(ray, opt.build);
+		if (const auto missed = PVSBuilder::missing<isWall>(visible, opt.build); missed > 0) {
+			std::cerr << "pvs: " << missed << " of " << opt.build.checkedSegments << " clear sight lines end in a cell the build missed."
+				<< " Nothing written: raise --samples.\n";
+			return 1;
+		}
+		if (opt.out.empty()) {
+			PVSBuilder::writeHeader<isWall>(std::cout, visible, opt.build);
+			return 0;
+		}
+		std::ofstream out{ opt.out };
+		PVSBuilder::writeHeader<isWall>(out, visible, opt.build);
+		if (!out) {
+			std::cerr << "can't write: " << opt.out << "\n";
+			return 1;
+		}
+		return 0;
+	}
+
+	int usage() {
+		std::cerr << "usage: RayCastBench [bench] [--warmup N] [--reps N]\n"
+			<< "       RayCastBench verify [--step N]\n"
+			<< "       RayCastBench replay <track> [--save F] [--golden F] [--max-slowdown PCT]\n"
+			<< "       RayCastBench pvs [--samples N] [--out F]\n";
+		return 1;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	int first = 1;
+	std::string_view command = "bench";
+	if (argc > 1 && argv[1][0] != '-') {
+		command = argv[1];
+		first = 2;
+	}
+	Bench::Options bench_opt{};
+	Verify::Options verify_opt{};
+	ReplayOptions replay_opt{};
+	PVSOptions pvs_opt{};
+	if (command == "replay") {
+		if (first >= argc) { return usage(); }
+		replay_opt.track = argv[first++];
+	}
+	for (int i = first; i < argc; i++) {
+		const std::string_view arg = argv[i];
+		const bool hasValue = (i + 1 < argc);
+		if (command == "bench" && arg == "--warmup" && hasValue && parseInt(argv[i + 1], bench_opt.warmup)) { i++; continue; }
+		if (command == "bench" && arg == "--reps" && hasValue && parseInt(argv[i + 1], bench_opt.repetitions) && bench_opt.repetitions > 0) { i++; continue; }
+		if (command == "verify" && arg == "--step" && hasValue && parseInt(argv[i + 1], verify_opt.step) && verify_opt.step > 0) { i++; continue; }
+		if (command == "replay" && arg == "--save" && hasValue) { replay_opt.save = argv[++i]; continue; }
+		if (command == "replay" && arg == "--golden" && hasValue) { replay_opt.golden = argv[++i]; continue; }
+		if (command == "replay" && arg == "--max-slowdown" && hasValue && parseInt(argv[i + 1], replay_opt.max_slowdown)) { i++; continue; }
+		if (command == "pvs" && arg == "--samples" && hasValue && parseInt(argv[i + 1], pvs_opt.build.samples)
+			&& pvs_opt.build.samples > 0 && pvs_opt.build.samples <= CELL_SIZE) { i++; continue; }
+		if (command == "pvs" && arg == "--out" && hasValue) { pvs_opt.out = argv[++i]; continue; }
+		return usage();
+	}
+	if (command == "bench") { return bench(bench_opt); }
+	if (command == "verify") { return verify(verify_opt); }
+	if (command == "replay") { return replay(replay_opt); }
+	if (command == "pvs") { return pvs(pvs_opt); }
+	return usage();
+}
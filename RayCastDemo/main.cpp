@@ -1,36 +1,223 @@
 #define SDL_MAIN_HANDLED
 #include <iostream>
+#include <optional>
+#include <string>
 #include <string_view>
 #include "src/Config.h"
 #include "src/ViewPoint.h"
+#include "src/Simulation.h"
+#include "src/SimulationThread.h"
+#include "src/Actions.h"
+#include "src/ActionRecorder.h"
+#include "src/FixedTimestep.h"
 #include "src/MiniMap.h"
 #include "src/SDLSystem.h"
 #include "src/Renderer.h"
 #include "src/Window.h"
 #include "src/InputManager.h"
 #include "src/RayCaster.h"
+#include "src/ResolutionController.h"
+#include "src/Timer.h"
+#include "src/Profiler.h"
+#include "src/LatencyMeter.h"
+#include "src/JobPool.h"
+#include "src/FrameArena.h"
+#include "src/HeapCounter.h"
 
-int main([[maybe_unused]]int argc, [[maybe_unused]] char* argv[]){
+struct Options {
+	std::string record; //write every tick's input to this file on exit
+	std::string replay; //play this file back instead of reading input. One tick per frame, so it reproduces frame-exactly.
+};
+
+static bool parseOptions(int argc, char* argv[], Options& opt) {
+	for (int i = 1; i < argc; i++) {
+		const std::string_view arg = argv[i];
+		const bool hasValue = (i + 1 < argc);
+		if (arg == "--record" && hasValue) { opt.record = argv[++i]; continue; }
+		if (arg == "--replay" && hasValue) { opt.replay = argv[++i]; continue; }
+		std::cerr << "usage: RayCastDemo [--record <file>] [--replay <file>]\n";
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]){
 	assert(testIsWallLookup());
+	Options _opt{};
+	if (!parseOptions(argc, argv, _opt)) {
+		return EXIT_FAILURE;
+	}
 	try {		
 		SDLSystem _sdl;
 		Window _window{ Cfg::TITLE, Cfg::WIN_WIDTH, Cfg::WIN_HEIGHT };		
-		Renderer _r{ _window };
-		Graphics _g(_r);
+		Renderer _r{ _window, Cfg::VSYNC };
 		InputManager _input{};				
 		RayCaster ray{};		
-		ViewPoint _viewPoint{ Cfg::START_POS_X, Cfg::START_POS_Y, ANGLE_0 };
+		IndexedFrameBuffer _fb{ Cfg::WIN_WIDTH, Cfg::WIN_HEIGHT, Cfg::hasIndexedFramebuffer() ? &_r : nullptr };
+		_fb.setPalette(ray.palette());
+		const Graphics _g = Cfg::hasIndexedFramebuffer() ? Graphics{ _fb, &_r } : Graphics{ _r, ray.palette() };
+		std::optional<JobPool> _jobs; //only when the entity loops are big enough to split: below GRAIN they run inline anyway
+		if constexpr (EntityStore::spreads(Cfg::ENTITY_COUNT) || Broadphase::spreads(Cfg::ENTITY_COUNT)) {
+			_jobs.emplace(Cfg::JOB_THREADS);
+		}
+		ActionRecorder _recorder{}; //before the simulation: it writes here until it stops
+		std::optional<ActionPlayback> _playback;
+		if (!_opt.replay.empty()) {
+			_playback.emplace(_opt.replay);
+			std::cout << "Replaying " << _playback->ticks() << " ticks from " << _opt.replay << "\n";
+		}
+		const bool lockstep = _playback.has_value(); //replays tick in step with frames, on this thread, so timing can't change the outcome
+		const bool threaded = Cfg::hasSimulationThread() && !lockstep;
+		ActionRecorder* recorder = _opt.record.empty() ? nullptr : &_recorder;
+		JobPool* jobs = _jobs ? &*_jobs : nullptr;
+		std::optional<SimulationThread> _simThread; //threaded: ticks on its own
+		std::optional<Simulation> _sim; //otherwise: ticked from the render loop
+		std::optional<FixedTimestep> _clock; //paces it, unless a replay does
+		if (threaded) {
+			_simThread.emplace();
+			_simThread->setRecorder(recorder);
+			_simThread->setJobPool(jobs);
+			_simThread->start();
+		}
+		else {
+			_sim.emplace();
+			_sim->setRecorder(recorder);
+			_sim->setJobPool(jobs);
+			if (!lockstep) {
+				_clock.emplace(Cfg::TICKS_PER_SECOND);
+			}
+		}
+		ResolutionController _resolution{};
 		//ray.prettyPrintLUTs();
-		while (!_input.quitRequested()) {
-			_input.update();						
-			_viewPoint.update(_input);
-			_viewPoint.checkCollisions();
+		PROFILE_THREAD("render");
+#ifdef USE_PROFILER
+		bool dumpKeyWasDown = false;
+#endif
+		bool statsKeyWasDown = false;
+		LatencyMeter _latency{};
+		bool latencyKeyWasDown = false;
+		CellSet explored{}; //every cell seen so far, for the minimap's fog of war
+		FrameArenas<> _frames{}; //transient per-frame lists
+		HeapCounter::SteadyStateCheck _heapCheck{};
+		while (!_input.quitRequested() && !(_playback && _playback->finished())) {
+			PROFILE_ZONE("frame");
+			const auto frameStart = Timer::now();
+			FrameArena& frame = _frames.beginFrame();
+			const auto heapAtFrameStart = HeapCounter::beginFrame();
+			if constexpr (Cfg::hasDynamicResolution()) {
+				ray.setResolution(_resolution.width(), _resolution.height());
+				_fb.setUpscale({ VIEWPORT_LEFT, VIEWPORT_TOP, ray.width(), ray.height() }, { VIEWPORT_LEFT, VIEWPORT_TOP, Cfg::VIEWPORT_WIDTH, Cfg::VIEWPORT_HEIGHT });
+			}
+			{
+				PROFILE_ZONE("InputManager::update");
+				_input.update();						
+			}
+			const Actions actions = sampleActions(_input);
+			if constexpr (Cfg::hasLatencyMeter()) {
+				_latency.onInput(_input.inputEventTime());
+				const bool latencyKeyDown = _input.isAnyKeyDown(Cfg::printLatency);
+				if (latencyKeyDown && !latencyKeyWasDown) {
+					_latency.print(std::cout);
+				}
+				latencyKeyWasDown = latencyKeyDown;
+			}
+#ifdef USE_PROFILER
+			const bool dumpKeyDown = _input.isAnyKeyDown(Cfg::dumpProfile);
+			if (dumpKeyDown && !dumpKeyWasDown) {
+				const auto path = std::string(_sdl.getPrefPath()) + "trace.json";
+				std::cout << (Profiler::dumpChromeTrace(path) ? "Wrote profile to " : "Failed to write profile to ") << path << "\n";
+			}
+			dumpKeyWasDown = dumpKeyDown;
+#endif
+
+			Snapshot snapshot;
+			float alpha = 1.0f;
+			if (lockstep) {
+				_sim->tick(_playback->next());
+				snapshot = _sim->snapshot();
+			}
+			else if (threaded) {
+				_simThread->submit(actions, _latency.pending());
+				snapshot = _simThread->latest();
+				alpha = _simThread->alpha(snapshot);
+			}
+			else {
+				for (int ticks = _clock->advance(); ticks > 0; ticks--) {
+					_sim->tick(actions, _latency.pending());
+				}
+				snapshot = _sim->snapshot();
+				alpha = _clock->alpha();
+			}
+			const Camera camera = Cfg::hasFrameInterpolation() ? snapshot.cameraAt(alpha) : snapshot.current;
 			_g.clearScreen();			
 			if constexpr (Cfg::hasMinimap()) { 
-				MiniMap::renderMap(_g);
+				MiniMap::renderMap(_g, Cfg::hasFogOfWar() ? &explored : nullptr);
+				if constexpr (Cfg::hasRayStats()) {
+					MiniMap::renderHeatmap(_g, ray.rayStats());
+				}
+			}
+			ray.renderView(_g, camera.x, camera.y, camera.angle);
+			ray.renderSprites(_g, camera.x, camera.y, camera.angle, snapshot.spriteList(), frame, Cfg::hasFrameInterpolation() ? alpha : 1.0f);
+			bool latchedInput = false; //the frame now reflects every input up to this point
+			if constexpr (Cfg::hasLateLatch()) {
+				PROFILE_ZONE("lateLatch");
+				_input.latch();
+				const Actions late = lockstep ? Actions{} : sampleActions(_input);
+				if constexpr (Cfg::hasLatencyMeter()) {
+					_latency.onInput(_input.inputEventTime());
+				}
+				//where the newest tick would be by now with the newest input, instead of trailing behind it by interpolation
+				const int latchedAngle = snapshot.current.angle + static_cast<int>(ViewPoint::turnRate(late) * alpha);
+				int delta = latchedAngle - camera.angle;
+				if (delta > ANGLE_180) { delta -= ANGLE_360; }
+				else if (delta < -ANGLE_180) { delta += ANGLE_360; }
+				latchedInput = !lockstep && ray.reproject(_g, _fb, camera.x, camera.y, camera.angle, delta) && ViewPoint::turnRate(late) != 0;
+			}
+			if constexpr (Cfg::hasFogOfWar()) { //after the late latch, so the cells its re-cast columns revealed are seen too
+				explored |= ray.visibleCells();
+			}
+			if constexpr (Cfg::hasRayStats()) { //after the late latch: its re-cast columns are part of the frame
+				const bool statsKeyDown = _input.isAnyKeyDown(Cfg::printRayStats);
+				if (statsKeyDown && !statsKeyWasDown) {
+					ray.rayStats().print(std::cout);
+				}
+				statsKeyWasDown = statsKeyDown;
+			}
+			if constexpr (Cfg::hasDynamicResolution()) {
+				_resolution.update(static_cast<float>(Timer::millisecondsSince(frameStart)));
+			}
+			{
+				PROFILE_ZONE("Graphics::present");
+				_g.present();
+			}
+			if constexpr (Cfg::hasLatencyMeter()) {
+				_latency.onPresent(latchedInput ? _latency.pending() : snapshot.inputTime);
+			}
+			if constexpr (HeapCounter::enabled()) {
+				const auto heap = HeapCounter::totals() - heapAtFrameStart; //on any thread, while this frame ran
+				if (_heapCheck.endFrame(heap) && Cfg::ON_STEADY_STATE_ALLOCATION != AllocationPolicy::COUNT
+					&& _heapCheck.dirtyFrames() <= Cfg::ALLOCATION_LOG_FRAMES) {
+					HeapCounter::report(std::cerr, heap);
+					SDL_assert_always(Cfg::ON_STEADY_STATE_ALLOCATION != AllocationPolicy::ASSERT && "The steady-state main loop allocated. See the report above.");
+				}
+				HeapCounter::arm(_heapCheck.steady() && Cfg::ON_STEADY_STATE_ALLOCATION != AllocationPolicy::COUNT);
+			}
+		}
+		if (_simThread) {
+			_simThread->stop(); //the recorder is written from the simulation thread
+		}
+		if (Cfg::hasLatencyMeter() && _latency.samples() > 0) {
+			_latency.print(std::cout);
+		}
+		if constexpr (HeapCounter::enabled()) {
+			_heapCheck.print(std::cout);
+			std::cout << "frame arenas: " << _frames.highWater() << " of " << Cfg::FRAME_ARENA_BYTES << " bytes used at most, " << _frames.overflows() << " overflows\n";
+		}
+		if (!_opt.record.empty()) {
+			std::cout << (_recorder.save(_opt.record) ? "Recorded " : "Failed to record ") << _recorder.ticks() << " ticks to " << _opt.record << "\n";
+			if (_recorder.dropped() > 0) {
+				std::cout << "The recording filled up: the last " << _recorder.dropped() << " ticks are missing. Raise Cfg::RECORDING_SECONDS.\n";
 			}
-			ray.renderView(_g, _viewPoint.x, _viewPoint.y, _viewPoint.angle);
-			_g.present();
 		}
 		return 0;		
 	}
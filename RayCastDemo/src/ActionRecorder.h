@@ -0,0 +1,67 @@
+#pragma once
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Actions.h"
+#include "ActionTrack.h"
+// Records the Actions consumed by every simulation tick, and plays them back. Since the simulation only ever sees
+// Actions (never raw SDL state), a replayed session is tick-for-tick identical to the recorded one.
+// Files are ActionTrack text: run-length encoded, so a token is only written when the input changes.
+// RayCastBench can replay the same files headless.
+class ActionRecorder {
+	std::vector<Actions> _ticks;
+	size_t _dropped = 0; //ticks past the reserved room, not recorded
+public:
+	explicit ActionRecorder(size_t capacity = static_cast<size_t>(Cfg::TICKS_PER_SECOND) * Cfg::RECORDING_SECONDS) {
+		_ticks.reserve(capacity);
+	}
+	//called by the simulation, once per tick. Never grows, so it can't throw out of a tick: once full, the rest is only counted.
+	void record(const Actions& input) noexcept {
+		if (_ticks.size() == _ticks.capacity()) {
+			_dropped++;
+			return;
+		}
+		_ticks.push_back(input);
+	}
+	size_t ticks() const noexcept {
+		return _ticks.size();
+	}
+	size_t dropped() const noexcept {
+		return _dropped;
+	}
+	bool save(const std::string& path) const {
+		std::ofstream out{ path };
+		out << "# " << _ticks.size() << " ticks at " << Cfg::TICKS_PER_SECOND << " ticks per second, from the start position\n";
+		out << ActionTrack::format(_ticks) << "\n";
+		return static_cast<bool>(out);
+	}
+};
+
+class ActionPlayback {
+	std::vector<Actions> _ticks;
+	size_t _next = 0;
+public:
+	explicit ActionPlayback(const std::string& path) {
+		std::ifstream in{ path };
+		if (!in) {
+			throw std::runtime_error("ActionPlayback: can't read " + path);
+		}
+		std::stringstream text;
+		text << in.rdbuf();
+		std::string error;
+		if (!ActionTrack::parse(text.str(), _ticks, error)) {
+			throw std::runtime_error("ActionPlayback: bad token '" + error + "' in " + path);
+		}
+	}
+	bool finished() const noexcept {
+		return _next >= _ticks.size();
+	}
+	Actions next() noexcept { //idle once the recording runs out
+		return finished() ? Actions{} : _ticks[_next++];
+	}
+	size_t ticks() const noexcept {
+		return _ticks.size();
+	}
+};
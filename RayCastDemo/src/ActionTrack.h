@@ -0,0 +1,103 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Actions.h"
+// A compact, human-editable text format for a sequence of per-tick Actions. Used to script camera paths for
+// headless replays (see RayCastBench), and small enough to commit long traces.
+// Whitespace separated tokens, run-length encoded:
+//   <keys><ticks>   hold keys for that many ticks. keys is any of l, r, f, b, x (rotate left/right, move forward/backward,
+//                   fire), or - for none. Eg. "f90 rf20 -5"
+//   <keys>t<x>,<y>  teleport to cell x, y (one tick), holding keys (none if left out). Eg. "t3,7" or "xt3,7"
+//   # ...           comment, to the end of the line
+namespace ActionTrack {
+	struct Key {
+		char symbol;
+		Actions::Action action;
+	};
+	static constexpr Key KEYS[]{
+		{ 'l', Actions::ROTATE_LEFT }, { 'r', Actions::ROTATE_RIGHT }, { 'f', Actions::MOVE_FORWARD }, { 'b', Actions::MOVE_BACKWARD }, { 'x', Actions::FIRE }
+	};
+
+	inline bool parseNumber(std::string_view text, int& out) noexcept {
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), out);
+		return error == std::errc{} && end == text.data() + text.size();
+	}
+
+	inline std::optional<Actions> parseKeys(std::string_view keys) noexcept {
+		Actions a{};
+		if (keys == "-") { return a; }
+		for (const char c : keys) {
+			const auto key = std::find_if(std::begin(KEYS), std::end(KEYS), [c](const Key& k) { return k.symbol == c; });
+			if (key == std::end(KEYS)) { return std::nullopt; }
+			a.held |= key->action;
+		}
+		return a;
+	}
+
+	//appends to out. Returns false (and the offending token in error) on malformed input.
+	inline bool parse(std::string_view text, std::vector<Actions>& out, std::string& error) {
+		size_t pos = 0;
+		while (pos < text.size()) {
+			const auto start = text.find_first_not_of(" \t\r\n", pos);
+			if (start == std::string_view::npos) { break; }
+			if (text[start] == '#') {
+				pos = text.find('\n', start);
+				continue;
+			}
+			const auto end = std::min(text.find_first_of(" \t\r\n", start), text.size());
+			const auto token = text.substr(start, end - start);
+			pos = end;
+			if (const auto t = token.find('t'); t != std::string_view::npos) {
+				auto actions = (t == 0) ? std::optional<Actions>{ Actions{} } : parseKeys(token.substr(0, t));
+				const auto comma = token.find(',', t);
+				int x = 0, y = 0;
+				if (!actions || comma == std::string_view::npos || !parseNumber(token.substr(t + 1, comma - t - 1), x) || !parseNumber(token.substr(comma + 1), y)
+					|| x < 0 || y < 0 || x >= WORLD_COLUMNS || y >= WORLD_ROWS) {
+					error = token;
+					return false;
+				}
+				actions->teleport = true;
+				actions->teleportCellX = static_cast<int8_t>(x);
+				actions->teleportCellY = static_cast<int8_t>(y);
+				out.push_back(*actions);
+				continue;
+			}
+			const auto digits = token.find_first_of("0123456789");
+			int ticks = 0;
+			const auto actions = (digits == 0 || digits == std::string_view::npos) ? std::nullopt : parseKeys(token.substr(0, digits));
+			if (!actions || !parseNumber(token.substr(digits), ticks) || ticks <= 0) {
+				error = token;
+				return false;
+			}
+			out.insert(out.end(), ticks, *actions);
+		}
+		return true;
+	}
+
+	inline std::string format(const std::vector<Actions>& track, int tokens_per_line = 16) {
+		std::string out;
+		int tokens = 0;
+		for (size_t i = 0; i < track.size(); tokens++) {
+			const auto& a = track[i];
+			if (tokens > 0) { out += (tokens % tokens_per_line == 0) ? '\n' : ' '; }
+			for (const auto& key : KEYS) {
+				if (a.isDown(key.action)) { out += key.symbol; }
+			}
+			if (a.teleport) { //the keys held on that tick fire, say, just the same
+				out += 't' + std::to_string(a.teleportCellX) + ',' + std::to_string(a.teleportCellY);
+				i++;
+				continue;
+			}
+			size_t run = 1;
+			while (i + run < track.size() && track[i + run] == a) { run++; }
+			if (a.held == 0) { out += '-'; }
+			out += std::to_string(run);
+			i += run;
+		}
+		return out;
+	}
+}
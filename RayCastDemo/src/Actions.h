@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include "Config.h"
+#include "LevelData.h"
+#include "InputManager.h"
+#include "MiniMap.h"
+//The simulation's view of the input: which Cfg::KeyMap actions are held, and where (if anywhere) the player clicked to teleport.
+//Plain data, so it can be handed across threads, recorded and replayed.
+struct Actions {
+	enum Action : uint8_t {
+		ROTATE_LEFT = 1 << 0,
+		ROTATE_RIGHT = 1 << 1,
+		MOVE_FORWARD = 1 << 2,
+		MOVE_BACKWARD = 1 << 3,
+		FIRE = 1 << 4
+	};
+	uint8_t held = 0; //bitmask of Action
+	bool teleport = false;
+	int8_t teleportCellX = 0;
+	int8_t teleportCellY = 0;
+
+	constexpr bool isDown(Action a) const noexcept {
+		return (held & a) != 0;
+	}
+	constexpr bool operator==(const Actions&) const noexcept = default;
+};
+static_assert(WORLD_COLUMNS <= INT8_MAX && WORLD_ROWS <= INT8_MAX, "Actions: teleport cells are stored in a byte");
+
+inline Actions sampleActions(const InputManager& input) {
+	Actions a{};
+	if (input.isAnyKeyDown(Cfg::rotateLeft)) { a.held |= Actions::ROTATE_LEFT; }
+	if (input.isAnyKeyDown(Cfg::rotateRight)) { a.held |= Actions::ROTATE_RIGHT; }
+	if (input.isAnyKeyDown(Cfg::moveForward)) { a.held |= Actions::MOVE_FORWARD; }
+	if (input.isAnyKeyDown(Cfg::moveBackward)) { a.held |= Actions::MOVE_BACKWARD; }
+	if (input.isAnyKeyDown(Cfg::fire)) { a.held |= Actions::FIRE; }
+	if (input.isButtonDown(MouseButton::LEFT)) {
+		const int mouseX = input.mouseX();
+		const int mouseY = input.mouseY();
+		const int mouseCellX = ((mouseX - MiniMap::MAP_LEFT) / MiniMap::SCALED_CELL_SIZE);
+		const int mouseCellY = mouseY / MiniMap::SCALED_CELL_SIZE;
+		if (!isWall(mouseCellX, mouseCellY)) {
+			a.teleport = true;
+			a.teleportCellX = static_cast<int8_t>(mouseCellX);
+			a.teleportCellY = static_cast<int8_t>(mouseCellY);
+		}
+	}
+	return a;
+}
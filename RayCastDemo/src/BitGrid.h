@@ -0,0 +1,72 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "Config.h"
+#include "LevelData.h"
+// Open cells of an arbitrarily sized grid as bitmaps, stored twice: by rows (bit x of row y) and by columns (bit y of column x).
+// A straight scan along either axis reads 64 cells per word, and finds the next cell of interest with a bit count
+// instead of stepping cell by cell. The level is 16x16; this is for pathfinding on larger maps, and for benchmarking.
+class BitGrid {
+public:
+	using Word = uint64_t;
+	static constexpr int WORD_BITS = 64;
+
+private:
+	int _width = 0;
+	int _height = 0;
+	int _rowWords = 0; //words per row
+	int _columnWords = 0; //words per column
+	std::vector<Word> _rows;
+	std::vector<Word> _columns;
+
+	static constexpr int wordsFor(int bits) noexcept { return (bits + WORD_BITS - 1) / WORD_BITS; }
+
+public:
+	BitGrid(int width, int height) : _width(width), _height(height), _rowWords(wordsFor(width)), _columnWords(wordsFor(height)),
+		_rows(static_cast<size_t>(_rowWords) * height, 0), _columns(static_cast<size_t>(_columnWords) * width, 0) {
+		assert(width > 0 && height > 0);
+	}
+
+	template<auto IsWall>
+	static BitGrid fromLevel() {
+		BitGrid grid(WORLD_COLUMNS, WORLD_ROWS);
+		for (int y = 0; y < WORLD_ROWS; y++) {
+			for (int x = 0; x < WORLD_COLUMNS; x++) {
+				grid.setOpen(x, y, !IsWall(x, y));
+			}
+		}
+		return grid;
+	}
+
+	int width() const noexcept { return _width; }
+	int height() const noexcept { return _height; }
+	bool inBounds(int x, int y) const noexcept {
+		return x >= 0 && x < _width && y >= 0 && y < _height;
+	}
+	bool isOpen(int x, int y) const noexcept { //out of bounds is blocked
+		return inBounds(x, y) && ((_rows[static_cast<size_t>(y) * _rowWords + x / WORD_BITS] >> (x % WORD_BITS)) & 1);
+	}
+	void setOpen(int x, int y, bool open) noexcept {
+		assert(inBounds(x, y) && "BitGrid: cell out of bounds");
+		const Word row_bit = Word{ 1 } << (x % WORD_BITS);
+		const Word column_bit = Word{ 1 } << (y % WORD_BITS);
+		auto& row = _rows[static_cast<size_t>(y) * _rowWords + x / WORD_BITS];
+		auto& column = _columns[static_cast<size_t>(x) * _columnWords + y / WORD_BITS];
+		row = open ? (row | row_bit) : (row & ~row_bit);
+		column = open ? (column | column_bit) : (column & ~column_bit);
+	}
+
+	// one row / column as words, for scans that combine several lines (eg. a row and its neighbours).
+	// Bits past the end of a line are always 0: blocked.
+	const Word* row(int y) const noexcept {
+		assert(y >= 0 && y < _height);
+		return &_rows[static_cast<size_t>(y) * _rowWords];
+	}
+	const Word* column(int x) const noexcept {
+		assert(x >= 0 && x < _width);
+		return &_columns[static_cast<size_t>(x) * _columnWords];
+	}
+	int rowWords() const noexcept { return _rowWords; }
+	int columnWords() const noexcept { return _columnWords; }
+};
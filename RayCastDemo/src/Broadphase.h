@@ -0,0 +1,156 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Config.h"
+#include "LevelData.h"
+#include "JobPool.h"
+// Uniform-grid broadphase over the level's own cells: which actors are near which, without testing every pair.
+// rebuild() counting-sorts the actors by cell, so each cell's actors (and each run of cells along a row) are one
+// contiguous range, with their positions copied alongside for the distance tests. The sort runs in chunks: every
+// chunk counts its own histogram, one prefix sum turns those into write offsets, and every chunk scatters its actors
+// in order. Both passes spread over a JobPool, the result is the same as a serial stable sort, and every buffer is
+// sized at construction, so rebuilding every tick allocates nothing.
+class Broadphase {
+public:
+	static constexpr int COLUMNS = WORLD_COLUMNS;
+	static constexpr int ROWS = WORLD_ROWS;
+	static constexpr int CELLS = COLUMNS * ROWS;
+	static constexpr size_t GRAIN = 8192; //actors per chunk
+	static constexpr bool spreads(size_t actors) noexcept { return actors > GRAIN; } //whether rebuild() can use more than one thread for this many
+
+private:
+	std::vector<uint32_t> _start; //CELLS + 1: the actors of cell c are _order[_start[c]] up to _order[_start[c + 1]]
+	std::vector<uint32_t> _order; //actor indices, sorted by cell
+	std::vector<int> _x, _y; //positions in sorted order
+	std::vector<uint16_t> _cell; //per actor, from the counting pass
+	std::vector<uint32_t> _counts; //per chunk, per cell. Turned into write offsets in place.
+	size_t _size = 0;
+
+	static int columnOf(int x) noexcept { return std::clamp(x >> CELL_SIZE_FP, 0, COLUMNS - 1); } //off the map counts as the edge
+	static int rowOf(int y) noexcept { return std::clamp(y >> CELL_SIZE_FP, 0, ROWS - 1); }
+	static size_t chunks(size_t actors) noexcept { return (actors + GRAIN - 1) / GRAIN; }
+
+	template<typename Fn>
+	void forEachChunk(size_t count, JobPool* jobs, const Fn& fn) {
+		auto range = [&](size_t first, size_t last) {
+			for (size_t chunk = first; chunk < last; chunk++) { fn(chunk, chunk * GRAIN, std::min((chunk + 1) * GRAIN, _size)); }
+		};
+		if (jobs) { jobs->parallelFor(count, 1, range); }
+		else { range(0, count); }
+	}
+
+	// fn(actor) for the actors in cells [left, right] of row whose center is within radius of (x, y)
+	template<typename Fn>
+	void scanRow(int row, int left, int right, int x, int y, int64_t radius_squared, const Fn& fn) const {
+		const auto first = _start[row * COLUMNS + left];
+		const auto last = _start[row * COLUMNS + right + 1]; //neighbouring cells of a row are neighbouring ranges
+		for (auto k = first; k < last; k++) {
+			const int64_t dx = _x[k] - x;
+			const int64_t dy = _y[k] - y;
+			if (dx * dx + dy * dy <= radius_squared) { fn(_order[k]); }
+		}
+	}
+
+public:
+	explicit Broadphase(size_t capacity) :
+		_start(CELLS + 1, 0), _order(capacity), _x(capacity), _y(capacity), _cell(capacity), _counts(chunks(capacity) * CELLS) {
+		static_assert(CELLS <= UINT16_MAX + 1, "Broadphase: cell indices are stored in 16 bits");
+	}
+
+	void rebuild(std::span<const int> xs, std::span<const int> ys, JobPool* jobs = nullptr) noexcept {
+		assert(xs.size() == ys.size() && xs.size() <= _order.size() && "Broadphase: more actors than it was sized for");
+		_size = xs.size();
+		const size_t chunk_count = chunks(_size);
+		forEachChunk(chunk_count, jobs, [&](size_t chunk, size_t begin, size_t end) {
+			auto* counts = &_counts[chunk * CELLS];
+			std::fill_n(counts, CELLS, 0);
+			for (size_t i = begin; i < end; i++) {
+				const auto cell = static_cast<uint16_t>(rowOf(ys[i]) * COLUMNS + columnOf(xs[i]));
+				_cell[i] = cell;
+				counts[cell]++;
+			}
+		});
+		uint32_t offset = 0;
+		for (int cell = 0; cell < CELLS; cell++) { //cell by cell, and within a cell chunk by chunk: a stable sort
+			_start[cell] = offset;
+			for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+				const auto count = _counts[chunk * CELLS + cell];
+				_counts[chunk * CELLS + cell] = offset;
+				offset += count;
+			}
+		}
+		_start[CELLS] = offset;
+		forEachChunk(chunk_count, jobs, [&](size_t chunk, size_t begin, size_t end) {
+			auto* next = &_counts[chunk * CELLS];
+			for (size_t i = begin; i < end; i++) {
+				const auto k = next[_cell[i]]++;
+				_order[k] = static_cast<uint32_t>(i);
+				_x[k] = xs[i];
+				_y[k] = ys[i];
+			}
+		});
+	}
+
+	// the actors whose position lies in cell (x, y), as indices into the arrays last passed to rebuild()
+	std::span<const uint32_t> inCell(int x, int y) const noexcept {
+		assert(x >= 0 && x < COLUMNS && y >= 0 && y < ROWS);
+		const int cell = y * COLUMNS + x;
+		return { _order.data() + _start[cell], _order.data() + _start[cell + 1] };
+	}
+
+	// fn(actor) for every actor within radius of (x, y), edge included
+	template<typename Fn>
+	void forEachInRadius(int x, int y, int radius, const Fn& fn) const {
+		const int left = columnOf(x - radius), right = columnOf(x + radius);
+		const int64_t radius_squared = int64_t{ radius } * radius;
+		for (int row = rowOf(y - radius); row <= rowOf(y + radius); row++) {
+			scanRow(row, left, right, x, y, radius_squared, fn);
+		}
+	}
+
+	// fn(actor) for every actor in the 3x3 cells around the one (x, y) is in. No distance test.
+	template<typename Fn>
+	void forEachNeighbor(int x, int y, const Fn& fn) const {
+		const int column = columnOf(x), row = rowOf(y);
+		const int left = std::max(column - 1, 0), right = std::min(column + 1, COLUMNS - 1);
+		for (int r = std::max(row - 1, 0); r <= std::min(row + 1, ROWS - 1); r++) {
+			for (auto k = _start[r * COLUMNS + left]; k < _start[r * COLUMNS + right + 1]; k++) { fn(_order[k]); }
+		}
+	}
+
+	// fn(a, b) once for every pair of actors within radius of each other, radius up to a cell. Each cell is paired
+	// with itself and the four neighbours ahead of it (east, and the three below), so no pair is seen twice.
+	template<typename Fn>
+	void forEachPair(int radius, const Fn& fn) const {
+		assert(radius <= CELL_SIZE && "Broadphase: pairs further apart than a cell may be in cells that aren't neighbours");
+		const int64_t radius_squared = int64_t{ radius } * radius;
+		for (int row = 0; row < ROWS; row++) {
+			for (int column = 0; column < COLUMNS; column++) {
+				const int cell = row * COLUMNS + column;
+				for (auto a = _start[cell]; a < _start[cell + 1]; a++) {
+					auto pair = [&](uint32_t b) { fn(_order[a], b); };
+					auto test = [&](uint32_t first, uint32_t last) {
+						for (auto k = first; k < last; k++) {
+							const int64_t dx = _x[k] - _x[a];
+							const int64_t dy = _y[k] - _y[a];
+							if (dx * dx + dy * dy <= radius_squared) { pair(_order[k]); }
+						}
+					};
+					test(a + 1, _start[cell + 1]);
+					if (column + 1 < COLUMNS) { test(_start[cell + 1], _start[cell + 2]); }
+					if (row + 1 < ROWS) {
+						const int below = cell + COLUMNS;
+						test(_start[below - (column > 0)], _start[below + (column + 1 < COLUMNS) + 1]);
+					}
+				}
+			}
+		}
+	}
+
+	size_t size() const noexcept { return _size; }
+	size_t capacity() const noexcept { return _order.size(); }
+};
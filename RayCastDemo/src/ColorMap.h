@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include "Config.h"
+#include "Graphics.h"
+
+// Doom-style light tables. Every palette color is pre-blended towards the fog color at LIGHT_LEVELS steps,
+// and a second table translates (quantized) distance into a light level.
+// Shading a column is then two table lookups instead of a handful of float multiplications per color channel.
+class ColorMap {
+public:
+    static constexpr auto LEVELS = Cfg::LIGHT_LEVELS;
+    static_assert(LEVELS * PALETTE_SIZE <= 256, "ColorMap: shaded palette indices must fit in a byte");
+    static constexpr auto DISTANCE_SHIFT = CELL_SIZE_FP - 2; //Optimization: quantize distances to quarter-cells with a shift instead of a divide.
+    static constexpr auto DISTANCE_STEPS = (Cfg::FOG_DISTANCE >> DISTANCE_SHIFT) + 1;
+
+private:
+    std::array<SDL_Color, LEVELS * PALETTE_SIZE> _shades{}; //[light level][palette index]. Level 0 is full bright.
+    std::array<uint8_t, DISTANCE_STEPS> _levels{}; //[distance >> DISTANCE_SHIFT] -> light level
+
+    static constexpr Uint8 blend(Uint8 from, Uint8 to, float amount) noexcept {
+        return static_cast<Uint8>(from + (to - from) * amount + 0.5f);
+    }
+
+    static float fogAmount(float distance) noexcept { //0 == no fog, 1 == only fog
+        const float t = distance / Cfg::FOG_DISTANCE;
+        if constexpr (Cfg::FOG_FALLOFF == FogFalloff::EXPONENTIAL) {
+            //normalized so that we still reach full fog at FOG_DISTANCE
+            return (1.0f - std::exp(-Cfg::FOG_DENSITY * t)) / (1.0f - std::exp(-Cfg::FOG_DENSITY));
+        }
+        return t;
+    }
+
+public:
+    // palette can be the global Palette[] or a texture's own palette, as long as it fits in PALETTE_SIZE entries.
+    explicit ColorMap(std::span<const SDL_Color> palette = Palette, const SDL_Color& fog = Cfg::FOG_COLOR) noexcept {
+        assert(palette.size() <= PALETTE_SIZE && "ColorMap: palette is too large to be shaded.");
+        for (int level = 0; level < LEVELS; level++) {
+            const float amount = static_cast<float>(level) / (LEVELS - 1);
+            for (size_t i = 0; i < palette.size(); i++) {
+                const auto& c = palette[i];
+                _shades[level * PALETTE_SIZE + i] = { blend(c.r, fog.r, amount), blend(c.g, fog.g, amount), blend(c.b, fog.b, amount), c.a };
+            }
+        }
+        for (int step = 0; step < DISTANCE_STEPS; step++) {
+            const float distance = static_cast<float>(step << DISTANCE_SHIFT);
+            const float fog_amount = Utils::clamp(fogAmount(distance), 0.0f, 1.0f);
+            _levels[step] = static_cast<uint8_t>(fog_amount * (LEVELS - 1) + 0.5f);
+        }
+    }
+
+    int lightLevel(float distance) const noexcept {
+        const auto step = static_cast<int>(distance) >> DISTANCE_SHIFT;
+        return (step >= 0 && step < DISTANCE_STEPS) ? _levels[step] : LEVELS - 1;
+    }
+
+    // all shades of one light level, indexed by palette index. Pick once per column, then index per pixel.
+    const SDL_Color* level(int level) const noexcept {
+        assert(level >= 0 && level < LEVELS);
+        return &_shades[level * PALETTE_SIZE];
+    }
+
+    const SDL_Color& shade(int level, int palette_index) const noexcept {
+        assert(palette_index >= 0 && palette_index < PALETTE_SIZE);
+        return this->level(level)[palette_index];
+    }
+
+    // index into palette(), for drawing with palette indices. Level 0 are the unshaded colors, so index(0, i) == i.
+    static constexpr int index(int level, int palette_index) noexcept {
+        return level * PALETTE_SIZE + palette_index;
+    }
+
+    // every shade, flattened. Hand this to Graphics / IndexedFrameBuffer as their palette.
+    std::span<const SDL_Color> palette() const noexcept {
+        return _shades;
+    }
+};
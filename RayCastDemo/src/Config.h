@@ -4,6 +4,19 @@
 #include "Keys.h"
 #include <string_view>
 #define USE_BITMAP_LEVELDATA
+#define USE_PROFILER //comment out to compile every PROFILE_ZONE away
+#ifdef _DEBUG
+#define COUNT_HEAP_ALLOCATIONS //count every operator new, to check the main loop doesn't allocate. See HeapCounter. Debug builds only: it replaces the global new.
+#endif
+enum class FogFalloff {
+	LINEAR,     //fog thickens evenly with distance
+	EXPONENTIAL //fog thickens quickly up close, then levels out. Tune with FOG_DENSITY.
+};
+enum class AllocationPolicy {
+	COUNT,  //tally steady-state allocations, print the totals on exit
+	LOG,    //also print who allocated, per profiler zone and with stack traces, the first few times it happens
+	ASSERT  //log, then stop in SDL's assertion handler. In every build, not just debug.
+};
 namespace Cfg {	
 	using KeyMap = Keys<3>;
 	using namespace std::literals::string_view_literals;	
@@ -12,25 +25,90 @@ namespace Cfg {
 	static constexpr auto MAP_SCALE_FACTOR = 2; //how many left shifts to perform (eg. 4 times smaller than the actual world)
 	static constexpr int WIN_WIDTH = 640;
 	static constexpr int WIN_HEIGHT = 480;	
-	static constexpr auto VIEWPORT_WIDTH = 128;
+	static constexpr auto VIEWPORT_WIDTH = 128; //full (maximum) render resolution
 	static constexpr auto VIEWPORT_HEIGHT = 64;
+	static constexpr bool DYNAMIC_RESOLUTION = true; //lower the render resolution at runtime to stay within FRAME_BUDGET_MS. Upscaled on present.
+	static constexpr auto FRAME_BUDGET_MS = 8.0f; //CPU time per frame, not counting the wait for vsync
+	static constexpr auto MIN_RESOLUTION_SCALE = 0.5f;
+	static constexpr auto RESOLUTION_STEPS = 8; //number of resolutions between full and MIN_RESOLUTION_SCALE
 	static constexpr auto VIEWPORT_LEFT = 0;
 	static constexpr auto VIEWPORT_TOP = 0;
 	static constexpr auto CELL_SIZE = 64; //width and height of a cell in the game world, must be a power of 2.   	
+	static constexpr bool INDEXED_FRAMEBUFFER = true; //draw palette indices into an 8-bit framebuffer, expand to RGBA once per frame
+	static constexpr bool DISTANCE_SHADING = true;
+	static constexpr auto LIGHT_LEVELS = 16; //how many pre-shaded copies of the palette to keep in the colormap. Doom used 32, but we must fit 16 colors * LIGHT_LEVELS in 8 bits.
+	static constexpr SDL_Color FOG_COLOR = { 0, 0, 0 }; //walls fade towards this color with distance. Black == darkness.
+	static constexpr auto FOG_FALLOFF = FogFalloff::LINEAR;
+	static constexpr auto FOG_DENSITY = 3.0f; //only used with FogFalloff::EXPONENTIAL. Higher == thicker fog up close.
+	static constexpr auto FOG_DISTANCE = 20 * CELL_SIZE; //distance (in world units) where walls become fully fogged
 	static constexpr auto FOV_DEGREES = 60; //Field of View, in degrees. We'll need to break these into RAY_COUNT sub-angles and cast a ray for each angle. We'll be using a lookup table for that        	
 	static const KeyMap rotateRight{ SDL_SCANCODE_KP_6, SDL_SCANCODE_RIGHT, SDL_SCANCODE_D };
 	static const KeyMap rotateLeft{ SDL_SCANCODE_KP_4, SDL_SCANCODE_LEFT, SDL_SCANCODE_A };
 	static const KeyMap moveForward{ SDL_SCANCODE_KP_8, SDL_SCANCODE_UP, SDL_SCANCODE_W };
 	static const KeyMap moveBackward{ SDL_SCANCODE_KP_2, SDL_SCANCODE_DOWN, SDL_SCANCODE_S };
+	static const KeyMap fire{ SDL_SCANCODE_KP_0, SDL_SCANCODE_SPACE, SDL_SCANCODE_LCTRL };
+	static const Keys<1> dumpProfile{ SDL_SCANCODE_F9 }; //writes a Chrome trace to the pref path. Needs USE_PROFILER.
+	static const Keys<1> printRayStats{ SDL_SCANCODE_F10 }; //prints this frame's ray histograms. Needs RAY_STATS.
+	static const Keys<1> printLatency{ SDL_SCANCODE_F11 }; //prints the input latency histogram. Needs MEASURE_LATENCY.
 	static constexpr auto START_POS_X = 1;
 	static constexpr auto START_POS_Y = 7;
-	static constexpr auto WALK_SPEED = 8;
-	static constexpr auto ROTATION_SPEED = 16;		
+	static constexpr auto WALK_SPEED = 8; //per tick
+	static constexpr bool SWEPT_COLLISION = true; //sweep each move against the walls, so moves longer than a cell (eg. fewer, longer ticks) can't tunnel through
+	static constexpr auto COLLISION_RADIUS = CELL_SIZE / 4; //how close to a wall an actor's center gets, with SWEPT_COLLISION. Otherwise OVERBOARD, in the direction of travel.
+	static constexpr auto ROTATION_SPEED = 16; //per tick
+	static constexpr auto TICKS_PER_SECOND = 60; //the simulation runs at a fixed rate, independent of the frame rate
+	static constexpr auto RECORDING_SECONDS = 60 * 10; //--record keeps this much input. Reserved up front: recording never allocates mid-tick.
+	static constexpr auto MAX_TICKS_PER_FRAME = 8; //after a long stall, drop time rather than trying to catch up all at once
+	static constexpr bool INTERPOLATE_FRAMES = true; //render in-between simulation ticks, for smooth motion at any frame rate
+	static constexpr bool RAY_STATS = false; //count cells visited per ray and draw a heatmap on the minimap. Costs a little per step.
+	static constexpr bool LATE_LATCH = true; //re-read input right before present and turn the finished frame to match, by shifting columns
+	static constexpr bool MEASURE_LATENCY = true; //time from input event to the present() that shows it. Printed on exit.
+	static constexpr bool VISIBLE_CELLS = true; //collect the open cells the view rays pass through, once per frame. See RayCaster::visibleCells().
+	static constexpr bool FOG_OF_WAR = true; //the minimap only shows cells that have been seen. Needs VISIBLE_CELLS.
+	static constexpr bool SIMULATION_THREAD = true; //tick the simulation on its own thread, decoupled from rendering
+	static constexpr auto ENTITY_COUNT = 1024; //actors wandering the level, ticked with the simulation. See EntityStore.
+	static constexpr auto MAX_SPRITES = 64; //billboards the renderer's sprite pass takes per frame. Also the room for them in a Snapshot.
+	static constexpr auto MAX_PROJECTILES = 48; //pooled, so firing never allocates. Firing with the pool full does nothing.
+	static constexpr auto PROJECTILE_SPEED = 24; //per tick
+	static constexpr auto PROJECTILE_RADIUS = 4; //for hitting walls, and drawn twice this size
+	static constexpr auto PROJECTILE_TICKS = 120; //lifetime, if it hits nothing
+	static constexpr auto FIRE_INTERVAL = 8; //ticks between shots while fire is held
+	static constexpr auto ACTOR_SPRITES = 16; //draw this many of the actors nearest the player, within ACTOR_SPRITE_RANGE. The rest of MAX_SPRITES is for projectiles.
+	static constexpr auto ACTOR_SPRITE_RANGE = 6 * CELL_SIZE;
+	static constexpr auto FRAME_ARENAS = 2; //per-frame arenas taking turns, so a frame's transient lists outlive it by one frame. See FrameArena.
+	static constexpr auto FRAME_ARENA_BYTES = 64 * 1024; //each. Overflows go to the heap, and show up in HeapCounter.
+	static constexpr auto TICK_ARENA_BYTES = 64 * 1024; //the simulation's scratch, reset every tick
+	static constexpr auto ALLOCATION_WARMUP_FRAMES = 120; //frames before HeapCounter expects the main loop to stop allocating
+	static constexpr auto ON_STEADY_STATE_ALLOCATION = AllocationPolicy::LOG; //needs COUNT_HEAP_ALLOCATIONS
+	static constexpr auto ALLOCATION_LOG_FRAMES = 8; //with LOG, stop reporting after this many frames have allocated
+	static constexpr auto JOB_THREADS = -1; //worker threads for parallel loops, besides the one asking. -1: one per remaining core.
+	static constexpr bool VSYNC = true;		
 	static constexpr auto TABLE_SIZE = static_cast<int>(VIEWPORT_WIDTH* (360.0f / FOV_DEGREES)); //how many elements we need to store the slope of every possible ray that can be projected.
 	//compile time feature-flags
 	constexpr bool hasMinimap() noexcept { return RENDER_MINIMAP; }
+	constexpr bool hasDistanceShading() noexcept { return DISTANCE_SHADING; }
+	constexpr bool hasIndexedFramebuffer() noexcept { return INDEXED_FRAMEBUFFER; }
+	constexpr bool hasDynamicResolution() noexcept { return DYNAMIC_RESOLUTION; }
+	constexpr bool hasFrameInterpolation() noexcept { return INTERPOLATE_FRAMES; }
+	constexpr bool hasSimulationThread() noexcept { return SIMULATION_THREAD; }
+	constexpr bool hasRayStats() noexcept { return RAY_STATS; }
+	constexpr bool hasLatencyMeter() noexcept { return MEASURE_LATENCY; }
+	constexpr bool hasLateLatch() noexcept { return LATE_LATCH; }
+	constexpr bool hasVisibleCells() noexcept { return VISIBLE_CELLS; }
+	constexpr bool hasFogOfWar() noexcept { return FOG_OF_WAR && RENDER_MINIMAP; }
+	constexpr bool hasEntities() noexcept { return ENTITY_COUNT > 0; }
+	constexpr bool hasSweptCollision() noexcept { return SWEPT_COLLISION; }
+	constexpr bool hasProjectiles() noexcept { return MAX_PROJECTILES > 0; }
 
 	static_assert(Utils::isPowerOfTwo(CELL_SIZE) && "Cell width and height must be a power-of-2");
+	static_assert(!DYNAMIC_RESOLUTION || INDEXED_FRAMEBUFFER, "Dynamic resolution upscales the indexed framebuffer at present");
+	static_assert(!LATE_LATCH || INDEXED_FRAMEBUFFER, "Late latching shifts columns inside the indexed framebuffer");
+	static_assert(!FOG_OF_WAR || VISIBLE_CELLS, "Fog of war reveals the cells collected by VISIBLE_CELLS");
+	static_assert(COLLISION_RADIUS > 0 && COLLISION_RADIUS <= CELL_SIZE / 2, "An actor must fit through a corridor one cell wide");
+	static_assert(MAX_PROJECTILES + ACTOR_SPRITES <= MAX_SPRITES, "Every projectile and actor sprite must fit in a Snapshot");
+	static_assert(PROJECTILE_RADIUS > 0 && PROJECTILE_RADIUS <= COLLISION_RADIUS, "Projectiles start at the player's center, so must fit where the player does");
+	static_assert(RESOLUTION_STEPS > 1 && MIN_RESOLUTION_SCALE > 0.0f && MIN_RESOLUTION_SCALE <= 1.0f);
+	static_assert(LIGHT_LEVELS > 1 && LIGHT_LEVELS <= 16 && "Shaded palette indices are stored as bytes (16 colors * 16 levels), and we need at least two levels");
 };
 
 //global constants derived from the config above:
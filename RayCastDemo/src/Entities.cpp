@@ -0,0 +1,193 @@
+#include "Entities.h"
+#if defined(__AVX2__) //MSVC /arch:AVX2 (set for the x64 configurations), -mavx2 elsewhere
+#include <immintrin.h>
+#define HAS_AVX2_ENTITIES
+#endif
+
+const char* EntityStore::kernel() noexcept {
+#ifdef HAS_AVX2_ENTITIES
+	return "avx2";
+#else
+	return "scalar";
+#endif
+}
+
+void EntityStore::stepScalar(const GridTraversal::WallRows& walls, size_t begin, size_t end) noexcept {
+	auto isWall = [&](int x, int y) { return GridTraversal::isWall(walls, x, y); };
+	for (size_t i = begin; i < end; i++) {
+		int angle = _angle[i] + _turn[i];
+		if (angle < ANGLE_0) { angle += ANGLE_360; }
+		else if (angle >= ANGLE_360) { angle -= ANGLE_360; }
+		_angle[i] = angle;
+		_dx[i] = _move[i] * Movement::WALK[angle].dx;
+		_dy[i] = _move[i] * Movement::WALK[angle].dy;
+		bool stuck = false;
+		if constexpr (Cfg::hasSweptCollision()) {
+			Movement::sweep(_x[i], _y[i], static_cast<int>(_dx[i]), static_cast<int>(_dy[i]), Cfg::COLLISION_RADIUS, isWall);
+			stuck = isWall(_x[i] / CELL_SIZE, _y[i] / CELL_SIZE);
+		}
+		else {
+			_x[i] += static_cast<int>(_dx[i]);
+			_y[i] += static_cast<int>(_dy[i]);
+			stuck = !Movement::pushOutOfWalls(_x[i], _y[i], _dx[i], _dy[i], isWall);
+		}
+		if (stuck) { //respawn, like ViewPoint
+			_x[i] = _y[i] = FIRST_VALID_CELL * CELL_SIZE + (CELL_SIZE >> 1);
+		}
+	}
+}
+
+#ifdef HAS_AVX2_ENTITIES
+namespace {
+	static_assert(sizeof(Movement::Step) == 2 * sizeof(float), "EntityStore gathers dx and dy with an 8 byte stride");
+
+	__m256i load(const int* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+	void store(int* p, __m256i v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+	//the WallRows row holding cell row y, for 8 rows. Clamped onto the border ring, like GridTraversal::isWall().
+	__m256i gatherRow(const GridTraversal::WallRows& walls, __m256i y) noexcept {
+		y = _mm256_max_epi32(_mm256_min_epi32(y, _mm256_set1_epi32(WORLD_ROWS)), _mm256_set1_epi32(-1));
+		return _mm256_i32gather_epi32(reinterpret_cast<const int*>(walls.data()), _mm256_add_epi32(y, _mm256_set1_epi32(1)), 4);
+	}
+	//the bit for column x in a WallRows row
+	__m256i columnBit(__m256i x) noexcept {
+		x = _mm256_max_epi32(_mm256_min_epi32(x, _mm256_set1_epi32(WORLD_COLUMNS)), _mm256_set1_epi32(-1));
+		return _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_add_epi32(x, _mm256_set1_epi32(1)));
+	}
+	//all ones where column x of row is a wall
+	__m256i wallAt(__m256i row, __m256i x) noexcept {
+		return _mm256_cmpgt_epi32(_mm256_and_si256(row, columnBit(x)), _mm256_setzero_si256());
+	}
+	__m256i cellOf(__m256i position) noexcept { return _mm256_srai_epi32(position, CELL_SIZE_FP); }
+	//bits at and above ring position k. Shifting by 32 or more gives 0, so any k >= 32 is an empty mask.
+	__m256i bitsFrom(__m256i k) noexcept { return _mm256_sllv_epi32(_mm256_set1_epi32(-1), k); }
+	//index of the lowest / highest set bit, of values below 2^24: read it off the exponent of the value as a float
+	__m256i exponentOf(__m256i power_of_two) noexcept {
+		return _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(power_of_two)), 23), _mm256_set1_epi32(127));
+	}
+	__m256i lowestBit(__m256i v) noexcept { return exponentOf(_mm256_and_si256(v, _mm256_sub_epi32(_mm256_setzero_si256(), v))); }
+	__m256i highestBit(__m256i v) noexcept { return exponentOf(v); }
+
+	// Movement::sweep() along x, for 8 actors. The square spans at most two rows (radius <= CELL_SIZE / 2), so the
+	// walls it could meet are those two rows OR'ed together, and the first wall column it enters is a bit scan in range.
+	__m256i sweepX(const GridTraversal::WallRows& walls, __m256i x, __m256i y, __m256i mx) noexcept {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi32(1);
+		const __m256i radius = _mm256_set1_epi32(Cfg::COLLISION_RADIUS);
+		const __m256i rows = _mm256_or_si256(gatherRow(walls, cellOf(_mm256_sub_epi32(y, radius))),
+			gatherRow(walls, cellOf(_mm256_sub_epi32(_mm256_add_epi32(y, radius), one))));
+		//right: columns from the one past our last unit, to the one the last unit moves into. Ring positions are column + 1.
+		const __m256i right_edge = _mm256_sub_epi32(_mm256_add_epi32(x, radius), one);
+		const __m256i right_first = _mm256_add_epi32(cellOf(right_edge), _mm256_set1_epi32(2));
+		const __m256i right_last = _mm256_add_epi32(cellOf(_mm256_add_epi32(right_edge, mx)), one);
+		const __m256i right_hits = _mm256_and_si256(_mm256_and_si256(rows, _mm256_cmpgt_epi32(mx, zero)),
+			_mm256_andnot_si256(bitsFrom(_mm256_add_epi32(right_last, one)), bitsFrom(right_first)));
+		//left: the same, mirrored. The far end is clamped to the ring, however far the move goes.
+		const __m256i left_edge = _mm256_sub_epi32(x, radius);
+		const __m256i left_first = cellOf(left_edge);
+		const __m256i left_last = _mm256_max_epi32(_mm256_add_epi32(cellOf(_mm256_add_epi32(left_edge, mx)), one), zero);
+		const __m256i left_hits = _mm256_and_si256(_mm256_and_si256(rows, _mm256_cmpgt_epi32(zero, mx)),
+			_mm256_andnot_si256(bitsFrom(_mm256_add_epi32(left_first, one)), bitsFrom(left_last)));
+		const __m256i cell = _mm256_set1_epi32(CELL_SIZE);
+		const __m256i right_stop = _mm256_sub_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(lowestBit(right_hits), one), cell), radius);
+		const __m256i left_stop = _mm256_add_epi32(_mm256_mullo_epi32(highestBit(left_hits), cell), radius);
+		x = _mm256_add_epi32(x, mx);
+		x = _mm256_blendv_epi8(x, right_stop, _mm256_cmpgt_epi32(right_hits, zero));
+		return _mm256_blendv_epi8(x, left_stop, _mm256_cmpgt_epi32(left_hits, zero));
+	}
+
+	// Movement::sweep() along y, for 8 actors: step the rows the leading edge enters, all lanes in lockstep, until
+	// every lane has hit a wall or run out of rows. Within a tick that's rarely more than one row.
+	__m256i sweepY(const GridTraversal::WallRows& walls, __m256i x, __m256i y, __m256i my) noexcept {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi32(1);
+		const __m256i radius = _mm256_set1_epi32(Cfg::COLLISION_RADIUS);
+		const __m256i columns = _mm256_or_si256(columnBit(cellOf(_mm256_sub_epi32(x, radius))),
+			columnBit(cellOf(_mm256_sub_epi32(_mm256_add_epi32(x, radius), one))));
+		const __m256i down = _mm256_cmpgt_epi32(my, zero);
+		const __m256i up = _mm256_cmpgt_epi32(zero, my);
+		const __m256i step = _mm256_or_si256(_mm256_and_si256(down, one), up); //+1, -1, or 0 when not moving
+		const __m256i edge = _mm256_blendv_epi8(_mm256_sub_epi32(y, radius), _mm256_sub_epi32(_mm256_add_epi32(y, radius), one), down);
+		const __m256i first = _mm256_add_epi32(cellOf(edge), step);
+		const __m256i last = cellOf(_mm256_add_epi32(edge, my));
+		__m256i count = _mm256_and_si256(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(last, first), step), one), _mm256_or_si256(down, up));
+		count = _mm256_max_epi32(count, zero);
+		__m256i row = first;
+		__m256i hit = zero;
+		for (__m256i active = _mm256_cmpgt_epi32(count, zero); !_mm256_testz_si256(active, active); ) {
+			const __m256i blocked = _mm256_and_si256(active, _mm256_cmpgt_epi32(_mm256_and_si256(gatherRow(walls, row), columns), zero));
+			hit = _mm256_or_si256(hit, blocked);
+			count = _mm256_sub_epi32(count, one);
+			active = _mm256_andnot_si256(blocked, _mm256_and_si256(active, _mm256_cmpgt_epi32(count, zero)));
+			row = _mm256_add_epi32(row, _mm256_and_si256(active, step)); //lanes that stopped keep the row they hit
+		}
+		const __m256i cell = _mm256_set1_epi32(CELL_SIZE);
+		const __m256i down_stop = _mm256_sub_epi32(_mm256_mullo_epi32(row, cell), radius);
+		const __m256i up_stop = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(row, one), cell), radius);
+		y = _mm256_add_epi32(y, my);
+		return _mm256_blendv_epi8(y, _mm256_blendv_epi8(up_stop, down_stop, down), hit);
+	}
+}
+
+// stepScalar(), 8 actors at a time. Positions are never negative (the level is walled in), so the cell is a shift
+// and the position within it a mask. Every branch of Movement::pushOutOfWalls() becomes a masked add, and
+// Movement::sweep() becomes a bit scan (x) and a short lockstep walk (y).
+void EntityStore::step(const GridTraversal::WallRows& walls, size_t begin, size_t end) noexcept {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i full_turn = _mm256_set1_epi32(ANGLE_360);
+	const __m256i cell_mask = _mm256_set1_epi32(CELL_SIZE - 1);
+	const __m256i near_edge = _mm256_set1_epi32(CELL_SIZE - OVERBOARD);
+	const __m256i overboard = _mm256_set1_epi32(OVERBOARD);
+	const __m256i respawn = _mm256_set1_epi32(FIRST_VALID_CELL * CELL_SIZE + (CELL_SIZE >> 1));
+	const __m256 fzero = _mm256_setzero_ps();
+	size_t i = begin;
+	for (; i + 8 <= end; i += 8) {
+		__m256i angle = _mm256_add_epi32(load(&_angle[i]), load(&_turn[i]));
+		angle = _mm256_add_epi32(angle, _mm256_and_si256(_mm256_cmpgt_epi32(zero, angle), full_turn));
+		angle = _mm256_sub_epi32(angle, _mm256_andnot_si256(_mm256_cmpgt_epi32(full_turn, angle), full_turn));
+		store(&_angle[i], angle);
+		const __m256 move = _mm256_loadu_ps(&_move[i]);
+		const __m256 dx = _mm256_mul_ps(move, _mm256_i32gather_ps(&Movement::WALK[0].dx, angle, 8));
+		const __m256 dy = _mm256_mul_ps(move, _mm256_i32gather_ps(&Movement::WALK[0].dy, angle, 8));
+		_mm256_storeu_ps(&_dx[i], dx);
+		_mm256_storeu_ps(&_dy[i], dy);
+		if constexpr (Cfg::hasSweptCollision()) {
+			const __m256i x = sweepX(walls, load(&_x[i]), load(&_y[i]), _mm256_cvttps_epi32(dx));
+			const __m256i y = sweepY(walls, x, load(&_y[i]), _mm256_cvttps_epi32(dy));
+			const __m256i stuck = wallAt(gatherRow(walls, cellOf(y)), cellOf(x));
+			store(&_x[i], _mm256_blendv_epi8(x, respawn, stuck));
+			store(&_y[i], _mm256_blendv_epi8(y, respawn, stuck));
+			continue;
+		}
+		__m256i x = _mm256_add_epi32(load(&_x[i]), _mm256_cvttps_epi32(dx));
+		__m256i y = _mm256_add_epi32(load(&_y[i]), _mm256_cvttps_epi32(dy));
+
+		const __m256i x_cell = cellOf(x);
+		const __m256i y_cell = cellOf(y);
+		const __m256i x_sub_cell = _mm256_and_si256(x, cell_mask);
+		const __m256i y_sub_cell = _mm256_and_si256(y, cell_mask);
+		const __m256i row = gatherRow(walls, y_cell);
+		const __m256i stuck = wallAt(row, x_cell);
+		const __m256i right = _mm256_and_si256(_mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(dx, fzero, _CMP_GT_OQ)), wallAt(row, _mm256_add_epi32(x_cell, one))),
+			_mm256_cmpgt_epi32(x_sub_cell, near_edge));
+		const __m256i left = _mm256_and_si256(_mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(dx, fzero, _CMP_LT_OQ)), wallAt(row, _mm256_sub_epi32(x_cell, one))),
+			_mm256_cmpgt_epi32(overboard, x_sub_cell));
+		const __m256i down = _mm256_and_si256(_mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(dy, fzero, _CMP_GT_OQ)), wallAt(gatherRow(walls, _mm256_add_epi32(y_cell, one)), x_cell)),
+			_mm256_cmpgt_epi32(y_sub_cell, near_edge));
+		const __m256i up = _mm256_and_si256(_mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(dy, fzero, _CMP_LT_OQ)), wallAt(gatherRow(walls, _mm256_sub_epi32(y_cell, one)), x_cell)),
+			_mm256_cmpgt_epi32(overboard, y_sub_cell));
+		x = _mm256_sub_epi32(x, _mm256_and_si256(right, _mm256_sub_epi32(x_sub_cell, near_edge)));
+		x = _mm256_add_epi32(x, _mm256_and_si256(left, _mm256_sub_epi32(overboard, x_sub_cell)));
+		y = _mm256_sub_epi32(y, _mm256_and_si256(down, _mm256_sub_epi32(y_sub_cell, near_edge)));
+		y = _mm256_add_epi32(y, _mm256_and_si256(up, _mm256_sub_epi32(overboard, y_sub_cell)));
+		store(&_x[i], _mm256_blendv_epi8(x, respawn, stuck));
+		store(&_y[i], _mm256_blendv_epi8(y, respawn, stuck));
+	}
+	stepScalar(walls, i, end);
+}
+#else
+void EntityStore::step(const GridTraversal::WallRows& walls, size_t begin, size_t end) noexcept {
+	stepScalar(walls, begin, end);
+}
+#endif
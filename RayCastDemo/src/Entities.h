@@ -0,0 +1,68 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "Config.h"
+#include "GridTraversal.h"
+#include "JobPool.h"
+#include "Movement.h"
+// Actors that walk the level, stored as structure-of-arrays: every field of every actor is its own contiguous array,
+// so a tick streams through memory and updates 8 actors per instruction (AVX2) instead of one ViewPoint at a time.
+// Each tick turns and walks every actor by its intent, with steps from Movement::WALK, and then pushes it out of the
+// walls exactly like ViewPoint::checkCollisions(). Storage is sized once, at construction; ticking never allocates.
+class EntityStore {
+	std::vector<int> _x, _y, _angle;
+	std::vector<int> _turn; //table angles per tick
+	std::vector<float> _move; //fraction of WALK_SPEED per tick. Negative walks backwards.
+	std::vector<float> _dx, _dy; //last tick's step, like ViewPoint::dx and dy
+	size_t _size = 0;
+
+public:
+	static constexpr size_t GRAIN = 4096; //actors per parallel chunk
+	static constexpr bool spreads(size_t actors) noexcept { return actors > GRAIN; } //whether tick() can use more than one thread for this many
+	static const char* kernel() noexcept; //"avx2" or "scalar": which loop tick() was compiled with
+
+	explicit EntityStore(size_t capacity) :
+		_x(capacity), _y(capacity), _angle(capacity), _turn(capacity), _move(capacity), _dx(capacity), _dy(capacity) {
+	}
+
+	size_t add(int x, int y, int angle) noexcept {
+		assert(_size < capacity() && "EntityStore: full. Size it for the level at construction.");
+		assert(angle >= ANGLE_0 && angle < ANGLE_360);
+		const size_t i = _size++;
+		_x[i] = x;
+		_y[i] = y;
+		_angle[i] = angle;
+		_turn[i] = 0;
+		_move[i] = _dx[i] = _dy[i] = 0.0f;
+		return i;
+	}
+	void clear() noexcept { _size = 0; }
+	void setIntent(size_t i, int turn, float move) noexcept {
+		assert(i < _size && turn > -ANGLE_360 && turn < ANGLE_360);
+		_turn[i] = turn;
+		_move[i] = move;
+	}
+
+	// Advance every actor one tick. Spread over jobs' threads when given one.
+	void tick(const GridTraversal::WallRows& walls, JobPool* jobs = nullptr) noexcept {
+		auto chunk = [&](size_t begin, size_t end) { step(walls, begin, end); };
+		if (jobs) { jobs->parallelFor(_size, GRAIN, chunk); }
+		else { chunk(0, _size); }
+	}
+	void tickScalar(const GridTraversal::WallRows& walls) noexcept { stepScalar(walls, 0, _size); } //the reference for tick()
+
+	size_t size() const noexcept { return _size; }
+	size_t capacity() const noexcept { return _x.size(); }
+	int x(size_t i) const noexcept { return _x[i]; }
+	int y(size_t i) const noexcept { return _y[i]; }
+	int angle(size_t i) const noexcept { return _angle[i]; }
+	std::span<const int> xs() const noexcept { return { _x.data(), _size }; }
+	std::span<const int> ys() const noexcept { return { _y.data(), _size }; }
+	std::span<const int> angles() const noexcept { return { _angle.data(), _size }; }
+
+private:
+	void step(const GridTraversal::WallRows& walls, size_t begin, size_t end) noexcept; //see Entities.cpp
+	void stepScalar(const GridTraversal::WallRows& walls, size_t begin, size_t end) noexcept;
+};
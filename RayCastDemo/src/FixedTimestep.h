@@ -0,0 +1,36 @@
+#pragma once
+#include "Config.h"
+#include "Timer.h"
+// Accumulates real time and hands it out in fixed-length ticks, so the simulation runs at the same rate
+// regardless of how fast (or slow) we render. alpha() is how far we are into the next tick, for interpolation.
+class FixedTimestep {
+	Uint64 _tickLength; //in performance counter units
+	Uint64 _maxElapsed;
+	Uint64 _last;
+	Uint64 _accumulator = 0;
+
+public:
+	explicit FixedTimestep(int ticksPerSecond, int maxTicksPerFrame = Cfg::MAX_TICKS_PER_FRAME) noexcept
+		: _tickLength(SDL_GetPerformanceFrequency() / ticksPerSecond),
+		_maxElapsed(_tickLength * maxTicksPerFrame),
+		_last(Timer::now()) {}
+
+	//call once per frame. Returns how many ticks to simulate.
+	int advance() noexcept {
+		const auto now = Timer::now();
+		const auto elapsed = now - _last;
+		_last = now;
+		_accumulator += (elapsed > _maxElapsed) ? _maxElapsed : elapsed; //avoid the spiral of death after a stall
+		const auto ticks = _accumulator / _tickLength;
+		_accumulator -= ticks * _tickLength;
+		return static_cast<int>(ticks);
+	}
+
+	float alpha() const noexcept {
+		return static_cast<float>(_accumulator) / static_cast<float>(_tickLength);
+	}
+
+	double tickSeconds() const noexcept {
+		return Timer::toSeconds(_tickLength);
+	}
+};
@@ -0,0 +1,234 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include "Config.h"
+#include "LevelData.h"
+#include "OccupancyGrid.h"
+// Paths to one goal for every cell at once. Agents that share a destination share a field, and each agent's
+// "which way now?" is a single lookup, no matter how many agents there are.
+class FlowField {
+public:
+	static constexpr int CELLS = WORLD_ROWS * WORLD_COLUMNS;
+	static constexpr uint16_t UNREACHABLE = 0xFFFF;
+	struct Step {
+		int8_t dx = 0, dy = 0; //towards the goal, in cells. {0, 0} at the goal and in unreachable cells.
+	};
+
+private:
+	std::array<uint16_t, CELLS> _distance{}; //in 4-connected steps
+	std::array<Step, CELLS> _step{};
+	int _goalX = -1, _goalY = -1;
+
+	using Row = OccupancyGrid::Row;
+
+	//pick the neighbour closest to the goal. Diagonals may not cut corners: both cells beside the diagonal must be open.
+	Step bestStep(const OccupancyGrid& grid, int x, int y) const noexcept {
+		Step best{};
+		int best_distance = _distance[cellIndex(x, y)];
+		if (best_distance == UNREACHABLE) { return best; }
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if (grid.isWall(x + dx, y + dy)) { continue; }
+				if (dx != 0 && dy != 0 && (grid.isWall(x + dx, y) || grid.isWall(x, y + dy))) { continue; }
+				const int d = _distance[cellIndex(x + dx, y + dy)];
+				if (d < best_distance) {
+					best_distance = d;
+					best = { static_cast<int8_t>(dx), static_cast<int8_t>(dy) };
+				}
+			}
+		}
+		return best;
+	}
+
+	void buildSteps(const OccupancyGrid& grid) noexcept {
+		for (int y = 0; y < WORLD_ROWS; y++) {
+			for (int x = 0; x < WORLD_COLUMNS; x++) {
+				_step[cellIndex(x, y)] = bestStep(grid, x, y);
+			}
+		}
+	}
+
+	//a cell's step depends on the walls and distances around it, so redo every cell next to one that changed
+	void updateSteps(const OccupancyGrid& grid, const CellSet& changed) noexcept {
+		CellSet dirty;
+		for (int cell = 0; cell < CELLS; cell++) {
+			if (!changed[cell]) { continue; }
+			const int x = cell % WORLD_COLUMNS, y = cell / WORLD_COLUMNS;
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					if (OccupancyGrid::inBounds(x + dx, y + dy)) { dirty[cellIndex(x + dx, y + dy)] = true; }
+				}
+			}
+		}
+		for (int cell = 0; cell < CELLS; cell++) {
+			if (dirty[cell]) { _step[cell] = bestStep(grid, cell % WORLD_COLUMNS, cell / WORLD_COLUMNS); }
+		}
+	}
+
+	// Breadth first search, one whole distance ring per iteration: every frontier row is grown left, right, up
+	// and down with shifts and ORs, then masked with the open cells that haven't been reached yet.
+	void buildDistances(const OccupancyGrid& grid) noexcept {
+		_distance.fill(UNREACHABLE);
+		if (grid.isWall(_goalX, _goalY)) { return; }
+		std::array<Row, WORLD_ROWS> frontier{};
+		std::array<Row, WORLD_ROWS> reached{};
+		frontier[_goalY] = Row{ 1 } << _goalX;
+		reached[_goalY] = frontier[_goalY];
+		_distance[cellIndex(_goalX, _goalY)] = 0;
+		for (uint16_t distance = 1; ; distance++) {
+			std::array<Row, WORLD_ROWS> next{};
+			Row any = 0;
+			for (int y = 0; y < WORLD_ROWS; y++) {
+				const Row above = (y > 0) ? frontier[y - 1] : 0;
+				const Row below = (y < WORLD_ROWS - 1) ? frontier[y + 1] : 0;
+				next[y] = ((frontier[y] << 1) | (frontier[y] >> 1) | above | below) & grid.openRow(y) & ~reached[y];
+				any |= next[y];
+			}
+			if (any == 0) { return; }
+			for (int y = 0; y < WORLD_ROWS; y++) {
+				reached[y] |= next[y];
+				for (Row bits = next[y]; bits != 0; bits &= bits - 1) { //visit each set bit
+					_distance[cellIndex(std::countr_zero(bits), y)] = distance;
+				}
+			}
+			frontier = next;
+		}
+	}
+
+	static constexpr int NEIGHBOUR_X[4]{ -1, 1, 0, 0 }; //the 4-connected steps the distances are counted in
+	static constexpr int NEIGHBOUR_Y[4]{ 0, 0, -1, 1 };
+
+	//a wall was removed: distances can only shrink. Breadth first from the new cell, through every cell it improves.
+	//Cells come off the queue in order of their new distance, so each one improves (and is queued) at most once.
+	void openCell(const OccupancyGrid& grid, int x, int y, CellSet& changed) noexcept {
+		int best = UNREACHABLE;
+		for (int n = 0; n < 4; n++) {
+			if (!grid.isWall(x + NEIGHBOUR_X[n], y + NEIGHBOUR_Y[n])) {
+				best = std::min<int>(best, _distance[cellIndex(x + NEIGHBOUR_X[n], y + NEIGHBOUR_Y[n])]);
+			}
+		}
+		if (best == UNREACHABLE) { return; } //opened into a region the goal can't reach
+		std::array<int, CELLS> queue;
+		int head = 0, tail = 0;
+		_distance[cellIndex(x, y)] = static_cast<uint16_t>(best + 1);
+		changed[cellIndex(x, y)] = true;
+		queue[tail++] = cellIndex(x, y);
+		while (head < tail) {
+			const int cell = queue[head++];
+			const int cx = cell % WORLD_COLUMNS, cy = cell / WORLD_COLUMNS;
+			const auto next = static_cast<uint16_t>(_distance[cell] + 1);
+			for (int n = 0; n < 4; n++) {
+				const int nx = cx + NEIGHBOUR_X[n], ny = cy + NEIGHBOUR_Y[n];
+				if (grid.isWall(nx, ny) || next >= _distance[cellIndex(nx, ny)]) { continue; }
+				assert(tail < CELLS);
+				_distance[cellIndex(nx, ny)] = next;
+				changed[cellIndex(nx, ny)] = true;
+				queue[tail++] = cellIndex(nx, ny);
+			}
+		}
+	}
+
+	//a wall was added. Only cells whose every shortest path ran through it get longer: some neighbour one step further out
+	//that has no other neighbour at the closed cell's distance. Returns false if there is one, and the distances need a rebuild.
+	bool closeCell(const OccupancyGrid& grid, int x, int y) noexcept {
+		const int closed = _distance[cellIndex(x, y)];
+		_distance[cellIndex(x, y)] = UNREACHABLE;
+		if (closed == UNREACHABLE) { return true; }
+		for (int n = 0; n < 4; n++) {
+			const int nx = x + NEIGHBOUR_X[n], ny = y + NEIGHBOUR_Y[n];
+			if (grid.isWall(nx, ny) || _distance[cellIndex(nx, ny)] != closed + 1) { continue; }
+			bool has_other_parent = false;
+			for (int m = 0; m < 4; m++) {
+				const int px = nx + NEIGHBOUR_X[m], py = ny + NEIGHBOUR_Y[m];
+				has_other_parent |= !grid.isWall(px, py) && _distance[cellIndex(px, py)] == closed;
+			}
+			if (!has_other_parent) { return false; }
+		}
+		return true;
+	}
+
+public:
+	void build(const OccupancyGrid& grid, int goal_x, int goal_y) noexcept {
+		assert(OccupancyGrid::inBounds(goal_x, goal_y) && "FlowField: goal out of bounds");
+		_goalX = goal_x;
+		_goalY = goal_y;
+		buildDistances(grid);
+		buildSteps(grid);
+	}
+
+	//grid has already been edited at (x, y). Patch the distances where we can, rebuild where we can't.
+	void onCellChanged(const OccupancyGrid& grid, int x, int y) noexcept {
+		CellSet changed;
+		changed[cellIndex(x, y)] = true; //its walls changed, so its neighbours' steps may too
+		if (grid.isWall(x, y)) {
+			if (!closeCell(grid, x, y)) {
+				buildDistances(grid);
+				return buildSteps(grid);
+			}
+		}
+		else if (isGoal(x, y)) { //the goal itself came back: everything starts from here again
+			buildDistances(grid);
+			return buildSteps(grid);
+		}
+		else {
+			openCell(grid, x, y, changed);
+		}
+		updateSteps(grid, changed);
+	}
+
+	Step step(int x, int y) const noexcept {
+		assert(OccupancyGrid::inBounds(x, y) && "FlowField: cell out of bounds");
+		return _step[cellIndex(x, y)];
+	}
+	int distance(int x, int y) const noexcept {
+		assert(OccupancyGrid::inBounds(x, y) && "FlowField: cell out of bounds");
+		return _distance[cellIndex(x, y)];
+	}
+	bool isGoal(int x, int y) const noexcept { return x == _goalX && y == _goalY; }
+};
+
+// A handful of fields, one per goal, kept up to date as the map changes. The least recently used field is
+// rebuilt for a new goal when all slots are taken.
+template<int SLOTS = 8>
+class FlowFieldCache {
+	struct Slot {
+		FlowField field;
+		int goal = -1; //cellIndex, -1 == free
+		uint32_t lastUse = 0;
+	};
+	OccupancyGrid& _grid;
+	std::array<Slot, SLOTS> _slots{};
+	uint32_t _clock = 0;
+
+public:
+	explicit FlowFieldCache(OccupancyGrid& grid) noexcept : _grid(grid) {}
+
+	const FlowField& field(int goal_x, int goal_y) noexcept {
+		const int goal = cellIndex(goal_x, goal_y);
+		Slot* slot = &_slots[0];
+		for (auto& s : _slots) {
+			if (s.goal == goal) {
+				s.lastUse = ++_clock;
+				return s.field;
+			}
+			if (s.lastUse < slot->lastUse) { slot = &s; } //free slots have never been used, so they go first
+		}
+		slot->goal = goal;
+		slot->lastUse = ++_clock;
+		slot->field.build(_grid, goal_x, goal_y);
+		return slot->field;
+	}
+
+	//edit the map through the cache, so every cached field sees the change
+	void setWall(int x, int y, bool wall) noexcept {
+		if (!_grid.setWall(x, y, wall)) { return; }
+		for (auto& s : _slots) {
+			if (s.goal >= 0) { s.field.onCellChanged(_grid, x, y); }
+		}
+	}
+
+	const OccupancyGrid& grid() const noexcept { return _grid; }
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "Config.h"
+// Linear allocator for data that only lives for one frame (or tick): draw lists, query results, scratch.
+// Allocating bumps a pointer through one block reserved at construction. Deallocating does nothing; reset() frees
+// everything at once. It is a std::pmr::memory_resource, so any std::pmr container can use it, see FrameVector.
+// Running out falls back to the heap rather than failing, and is counted: raise the size until overflows() stays 0.
+// Not thread safe: one arena per thread.
+class FrameArena final : public std::pmr::memory_resource {
+	std::unique_ptr<std::byte[]> _block;
+	size_t _capacity = 0;
+	size_t _used = 0;
+	size_t _highWater = 0; //most ever used between two resets
+	size_t _overflows = 0; //allocations that didn't fit, since construction
+	FrameArena(const FrameArena&) = delete; //disable copy constructor
+	FrameArena& operator=(FrameArena&) = delete; //disable copy assignment
+
+	bool owns(const void* p) const noexcept {
+		return p >= _block.get() && p < _block.get() + _capacity;
+	}
+
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		const auto base = reinterpret_cast<uintptr_t>(_block.get());
+		const auto start = (base + _used + alignment - 1) & ~(uintptr_t{ alignment } - 1);
+		const auto end = start - base + bytes;
+		if (end > _capacity) {
+			_overflows++;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+		_used = end;
+		_highWater = (_used > _highWater) ? _used : _highWater;
+		return reinterpret_cast<void*>(start);
+	}
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+		if (!owns(p)) { //an overflow
+			std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+	}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+	explicit FrameArena(size_t capacity) : _block(std::make_unique<std::byte[]>(capacity)), _capacity(capacity) {}
+
+	// Everything allocated since the last reset() is gone. Containers using it must be gone too.
+	void reset() noexcept { _used = 0; }
+
+	size_t used() const noexcept { return _used; }
+	size_t capacity() const noexcept { return _capacity; }
+	size_t highWater() const noexcept { return _highWater; }
+	size_t overflows() const noexcept { return _overflows; }
+};
+
+// A std::vector that allocates from a FrameArena: FrameVector<int> list{ &arena };
+// reserve() up front when the size is known. Growing leaves the old buffers in the arena until the reset.
+template<typename T>
+using FrameVector = std::pmr::vector<T>;
+
+// COUNT arenas, taking turns a frame at a time. A frame's arena is reset when it comes round again, so what one frame
+// builds stays valid through the next COUNT - 1 frames: enough for a pipelined renderer to consume it a frame later.
+template<size_t COUNT = Cfg::FRAME_ARENAS>
+class FrameArenas {
+	static_assert(COUNT > 0);
+	std::array<std::unique_ptr<FrameArena>, COUNT> _arenas;
+	size_t _current = 0;
+
+public:
+	explicit FrameArenas(size_t capacity = Cfg::FRAME_ARENA_BYTES) {
+		for (auto& arena : _arenas) {
+			arena = std::make_unique<FrameArena>(capacity);
+		}
+	}
+	// Call once at the start of every frame. Returns the frame's arena, emptied.
+	FrameArena& beginFrame() noexcept {
+		_current = (_current + 1) % COUNT;
+		_arenas[_current]->reset();
+		return *_arenas[_current];
+	}
+	FrameArena& current() noexcept { return *_arenas[_current]; }
+	FrameArena& previous() noexcept { return *_arenas[(_current + COUNT - 1) % COUNT]; }
+
+	size_t highWater() const noexcept {
+		size_t most = 0;
+		for (const auto& arena : _arenas) { most = (arena->highWater() > most) ? arena->highWater() : most; }
+		return most;
+	}
+	size_t overflows() const noexcept {
+		size_t total = 0;
+		for (const auto& arena : _arenas) { total += arena->overflows(); }
+		return total;
+	}
+};
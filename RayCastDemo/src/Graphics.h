@@ -1,5 +1,8 @@
 #pragma once
+#include <cassert>
+#include <span>
 #include "Renderer.h"
+#include "IndexedFrameBuffer.h"
 enum class RectStyle {
     OUTLINE,
     FILL
@@ -29,36 +32,71 @@ static constexpr SDL_Color Palette[PALETTE_SIZE]{
     DarkGray, LightBlue, LightGreen, LightCyan, //8, 9, 10, 11
     LightRed, LightMagenta, Yellow, White       //12, 13, 14, 15 
 };
+//reverse lookup, SDL_Color -> original LUT value. Lets us name palette entries by color at compile time.
+constexpr int paletteIndexOf(const SDL_Color& c) noexcept {
+    for (int i = 0; i < PALETTE_SIZE; i++) {
+        if (Palette[i].r == c.r && Palette[i].g == c.g && Palette[i].b == c.b) { return i; }
+    }
+    return -1;
+}
+using PaletteIndex = IndexedFrameBuffer::PaletteIndex;
+//Graphics draws with palette indices, either into an 8-bit framebuffer or straight to the renderer (translating through _palette).
 struct Graphics{
-    const Renderer& _r;
-    Graphics(const Renderer& r) : _r(r) {};
+    const Renderer* _r = nullptr; //null when running headless
+    IndexedFrameBuffer* _fb = nullptr; //null when drawing straight to the renderer
+    std::span<const SDL_Color> _palette = Palette; //palette index -> color, only used when drawing straight to the renderer
+    Graphics(const Renderer& r, std::span<const SDL_Color> palette = Palette) : _r(&r), _palette(palette) {};
+    Graphics(IndexedFrameBuffer& fb, const Renderer* r = nullptr) : _r(r), _fb(&fb) {};
 
     void clearScreen() const noexcept {
-        _r.setColor(Black);
-        _r.clear();
+        if (_fb) {
+            return _fb->clear(0);
+        }
+        _r->setColor(_palette[0]);
+        _r->clear();
     }
     void present() const noexcept {
-        _r.present();
+        if (_fb) {
+            if (_r) { _fb->present(*_r); }
+            return;
+        }
+        _r->present();
     }
-    void setColor(const SDL_Color& color) const noexcept {
-        _r.setColor(color);
+    void setColor(int palette_index) const noexcept {
+        assert(palette_index >= 0 && palette_index < IndexedFrameBuffer::MAX_COLORS);
+        if (_fb) {
+            return _fb->setColor(static_cast<PaletteIndex>(palette_index));
+        }
+        _r->setColor(_palette[palette_index]);
     }
     void drawLine(int x1, int y1, int x2, int y2) const noexcept {
-        _r.drawLine(x1, y1, x2, y2);
+        if (_fb) {
+            return _fb->drawLine(x1, y1, x2, y2);
+        }
+        _r->drawLine(x1, y1, x2, y2);
     } 
     void drawVerticalLine(int x, int y, int height) const noexcept { //future optimization possibility, particularly on Arduboy (fastVLine / fastHLine). 
-        _r.drawLine(x, y, x, y+height); 
+        if (_fb) {
+            return _fb->drawVerticalLine(x, y, y + height);
+        }
+        _r->drawLine(x, y, x, y+height); 
     }   
     void setPixel(int x, int y) const noexcept {
-        _r.drawPoint(x, y);
+        if (_fb) {
+            return _fb->setPixel(x, y);
+        }
+        _r->drawPoint(x, y);
     }
     void drawRectangle(RectStyle style, int left, int top, int right, int bottom) const noexcept {
         SDL_Rect rect{ left, top, right - left, bottom - top };
+        if (_fb) {
+            return (style == RectStyle::FILL) ? _fb->drawFilledRect(rect) : _fb->drawRect(rect);
+        }
         if (style == RectStyle::FILL) {
-            _r.drawFilledRect(rect);
+            _r->drawFilledRect(rect);
         }
         else {
-            _r.drawRect(rect);
+            _r->drawRect(rect);
         }
     }
 };
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "GridTraversal.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HAS_AVX2_TRAVERSAL
+#endif
+
+namespace GridTraversal {
+	bool isClear(const WallRows& rows, const Query& q) noexcept {
+		AxisWalk vertical, horizontal;
+		int vertical_left = initSegmentWalk(q.x0, q.y0, q.x1, q.y1, vertical);
+		int horizontal_left = initSegmentWalk(q.y0, q.x0, q.y1, q.x1, horizontal);
+		for (; vertical_left > 0; vertical_left--, advance(vertical)) {
+			if (isWall(rows, cellX<true>(vertical), cellY<true>(vertical))) { return false; }
+		}
+		for (; horizontal_left > 0; horizontal_left--, advance(horizontal)) {
+			if (isWall(rows, cellX<false>(horizontal), cellY<false>(horizontal))) { return false; }
+		}
+		return true;
+	}
+
+#ifdef HAS_AVX2_TRAVERSAL
+	namespace {
+		static constexpr int LANES = 8;
+
+		//one AxisWalk per lane, structure-of-arrays
+		struct WalkLanes {
+			alignas(32) float intercept[LANES]{};
+			alignas(32) float step[LANES]{};
+			alignas(32) int boundary[LANES]{};
+			alignas(32) int delta[LANES]{};
+			alignas(32) int next_cell[LANES]{};
+			alignas(32) int left[LANES]{}; //boundaries still to cross. Unused lanes stay at 0.
+
+			void set(int lane, const AxisWalk& w, int crossings) noexcept {
+				intercept[lane] = w.intercept;
+				step[lane] = w.step;
+				boundary[lane] = w.boundary;
+				delta[lane] = w.delta;
+				next_cell[lane] = w.next_cell;
+				left[lane] = crossings;
+			}
+		};
+
+		__m256i load(const int* p) noexcept { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+
+		//isWall(rows, x, y) for 8 cells: clamp onto the border ring, gather the rows, shift out the bits
+		__m256i isWall8(const WallRows& rows, __m256i x, __m256i y) noexcept {
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i minus_one = _mm256_set1_epi32(-1);
+			x = _mm256_add_epi32(_mm256_max_epi32(_mm256_min_epi32(x, _mm256_set1_epi32(WORLD_COLUMNS)), minus_one), one);
+			y = _mm256_add_epi32(_mm256_max_epi32(_mm256_min_epi32(y, _mm256_set1_epi32(WORLD_ROWS)), minus_one), one);
+			const __m256i row = _mm256_i32gather_epi32(reinterpret_cast<const int*>(rows.data()), y, 4);
+			const __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(row, x), one);
+			return _mm256_cmpeq_epi32(bit, one); //all ones where there's a wall
+		}
+
+		//trace up to 8 queries at once. Returns one bit per lane, set if that lane hit a wall.
+		int blockedLanes(const WallRows& rows, const WalkLanes& v, const WalkLanes& h) noexcept {
+			__m256 v_intercept = _mm256_load_ps(v.intercept);
+			__m256i v_boundary = load(v.boundary);
+			__m256i v_left = load(v.left);
+			__m256 h_intercept = _mm256_load_ps(h.intercept);
+			__m256i h_boundary = load(h.boundary);
+			__m256i h_left = load(h.left);
+			const __m256 v_step = _mm256_load_ps(v.step), h_step = _mm256_load_ps(h.step);
+			const __m256i v_delta = load(v.delta), h_delta = load(h.delta);
+			const __m256i v_next = load(v.next_cell), h_next = load(h.next_cell);
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i one = _mm256_set1_epi32(1);
+			__m256i blocked = zero;
+			while (true) {
+				const __m256i v_active = _mm256_andnot_si256(blocked, _mm256_cmpgt_epi32(v_left, zero));
+				const __m256i h_active = _mm256_andnot_si256(blocked, _mm256_cmpgt_epi32(h_left, zero));
+				if (_mm256_testz_si256(_mm256_or_si256(v_active, h_active), _mm256_or_si256(v_active, h_active))) {
+					break; //every lane has hit a wall or arrived
+				}
+				//same cell math as cellX() / cellY(): vertical walks cross x boundaries, horizontal walks cross y boundaries
+				const __m256i v_x = _mm256_srai_epi32(_mm256_add_epi32(v_boundary, v_next), CELL_SIZE_FP);
+				const __m256i v_y = _mm256_srai_epi32(_mm256_cvttps_epi32(v_intercept), CELL_SIZE_FP);
+				const __m256i h_x = _mm256_srai_epi32(_mm256_cvttps_epi32(h_intercept), CELL_SIZE_FP);
+				const __m256i h_y = _mm256_srai_epi32(_mm256_add_epi32(h_boundary, h_next), CELL_SIZE_FP);
+				blocked = _mm256_or_si256(blocked, _mm256_and_si256(v_active, isWall8(rows, v_x, v_y)));
+				blocked = _mm256_or_si256(blocked, _mm256_and_si256(h_active, isWall8(rows, h_x, h_y)));
+				//advance() every lane. Finished lanes run on harmlessly, they are masked out above.
+				v_intercept = _mm256_add_ps(v_intercept, v_step);
+				v_boundary = _mm256_add_epi32(v_boundary, v_delta);
+				v_left = _mm256_sub_epi32(v_left, one);
+				h_intercept = _mm256_add_ps(h_intercept, h_step);
+				h_boundary = _mm256_add_epi32(h_boundary, h_delta);
+				h_left = _mm256_sub_epi32(h_left, one);
+			}
+			return _mm256_movemask_ps(_mm256_castsi256_ps(blocked));
+		}
+	}
+#endif
+
+	const char* lineOfSightKernel() noexcept {
+#ifdef HAS_AVX2_TRAVERSAL
+		return "avx2";
+#else
+		return "scalar";
+#endif
+	}
+
+	void lineOfSight(const WallRows& rows, std::span<const Query> queries, std::span<uint64_t> result) noexcept {
+		assert(result.size() * 64 >= queries.size() && "lineOfSight: result is too small for the number of queries");
+		std::fill(result.begin(), result.end(), 0);
+		size_t i = 0;
+#ifdef HAS_AVX2_TRAVERSAL
+		for (; i + LANES <= queries.size(); i += LANES) {
+			WalkLanes vertical, horizontal;
+			for (int lane = 0; lane < LANES; lane++) {
+				const auto& q = queries[i + lane];
+				AxisWalk w;
+				vertical.set(lane, w, initSegmentWalk(q.x0, q.y0, q.x1, q.y1, w));
+				horizontal.set(lane, w, initSegmentWalk(q.y0, q.x0, q.y1, q.x1, w));
+			}
+			const auto clear = static_cast<uint64_t>(~blockedLanes(rows, vertical, horizontal) & 0xFF);
+			result[i >> 6] |= clear << (i & 63); //i is a multiple of 8, so a batch never straddles two words
+		}
+#endif
+		for (; i < queries.size(); i++) {
+			if (isClear(rows, queries[i])) {
+				result[i >> 6] |= uint64_t{ 1 } << (i & 63);
+			}
+		}
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include "Config.h"
+#include "LevelData.h"
+// The cell-boundary walk at the heart of the ray caster, shared with anything else that needs to trace through the map.
+// A ray is traced as two independent walks: one across vertical cell boundaries (x = n * CELL_SIZE) and one across
+// horizontal ones. Each walk steps a whole cell at a time and tests the cell on the far side of every boundary.
+namespace GridTraversal {
+    struct AxisWalk {
+        float intercept = 0.0f; //where the ray crosses the current boundary, along the other axis
+        float step = 0.0f; //change of intercept per cell
+        int boundary = 0; //the current boundary line, in world units
+        int delta = 0; //+-CELL_SIZE, towards the next boundary
+        int next_cell = 0; //0 or -1: offset to the cell on the far side of the boundary
+    };
+
+    //the cell on the far side of the current boundary. Vertical walks cross x boundaries, horizontal walks cross y boundaries.
+    template<bool VERTICAL>
+    constexpr int cellX(const AxisWalk& w) noexcept {
+        if constexpr (VERTICAL) {
+            return (w.boundary + w.next_cell) >> CELL_SIZE_FP; //Optimization: shift instead of divide, might help the Arduboy
+        }
+        return static_cast<int>(w.intercept) >> CELL_SIZE_FP;
+    }
+    template<bool VERTICAL>
+    constexpr int cellY(const AxisWalk& w) noexcept {
+        if constexpr (VERTICAL) {
+            return static_cast<int>(w.intercept) >> CELL_SIZE_FP;
+        }
+        return (w.boundary + w.next_cell) >> CELL_SIZE_FP;
+    }
+    template<auto IsWall, bool VERTICAL>
+    constexpr bool hitsWall(const AxisWalk& w) noexcept {
+        return IsWall(cellX<VERTICAL>(w), cellY<VERTICAL>(w));
+    }
+    constexpr void advance(AxisWalk& w) noexcept {
+        w.intercept += w.step;
+        w.boundary += w.delta;
+    }
+
+    // A segment from (x0, y0) to (x1, y1), in world units. Hitscan weapons trace muzzle -> target the same way.
+    struct Query {
+        int x0 = 0, y0 = 0;
+        int x1 = 0, y1 = 0;
+    };
+
+    //set up the walk across the boundaries of one axis from a to b. Returns how many boundaries the segment crosses.
+    //(a, b) are coordinates along the walked axis, (oa, ob) along the other one.
+    inline int initSegmentWalk(int a, int oa, int b, int ob, AxisWalk& w) noexcept {
+        const int cell_a = a >> CELL_SIZE_FP;
+        const int crossings = std::abs((b >> CELL_SIZE_FP) - cell_a);
+        if (crossings == 0) { return 0; }
+        const bool forward = (b > a);
+        const float slope = static_cast<float>(ob - oa) / static_cast<float>(b - a);
+        w.boundary = forward ? (cell_a + 1) << CELL_SIZE_FP : cell_a << CELL_SIZE_FP;
+        w.delta = forward ? CELL_SIZE : -CELL_SIZE;
+        w.next_cell = forward ? 0 : -1;
+        w.intercept = oa + slope * (w.boundary - a);
+        w.step = slope * w.delta;
+        return crossings;
+    }
+
+    // Every cell the segment from (x0, y0) to (x1, y1) passes through, walls included: the start cell first, then the cells
+    // beyond each vertical boundary, then those beyond each horizontal one. Not in order of distance.
+    template<typename Visit>
+    void forEachCell(int x0, int y0, int x1, int y1, Visit&& visit) noexcept {
+        visit(x0 >> CELL_SIZE_FP, y0 >> CELL_SIZE_FP);
+        AxisWalk w;
+        for (int left = initSegmentWalk(x0, y0, x1, y1, w); left > 0; left--, advance(w)) {
+            visit(cellX<true>(w), cellY<true>(w));
+        }
+        for (int left = initSegmentWalk(y0, x0, y1, x1, w); left > 0; left--, advance(w)) {
+            visit(cellX<false>(w), cellY<false>(w));
+        }
+    }
+
+    // The map as one bitmask per row, with a ring of wall cells around it: bit (x + 1) of row (y + 1) is IsWall(x, y).
+    // Any cell outside the ring is clamped onto it, so lookups need no bounds checks and can be done 8 at a time with a gather.
+    using WallRows = std::array<uint32_t, WORLD_ROWS + 2>;
+    static_assert(WORLD_COLUMNS + 2 <= 32, "GridTraversal: WallRows packs a row and its border into 32 bits");
+
+    template<auto IsWall>
+    constexpr WallRows wallRows() noexcept {
+        WallRows rows{};
+        for (int y = -1; y <= WORLD_ROWS; y++) {
+            for (int x = -1; x <= WORLD_COLUMNS; x++) {
+                if (IsWall(x, y)) { rows[y + 1] |= uint32_t{ 1 } << (x + 1); }
+            }
+        }
+        return rows;
+    }
+
+    constexpr bool isWall(const WallRows& rows, int x, int y) noexcept {
+        x = std::clamp(x, -1, WORLD_COLUMNS);
+        y = std::clamp(y, -1, WORLD_ROWS);
+        return (rows[y + 1] >> (x + 1)) & 1;
+    }
+
+    // "Can A see B". True if the segment never crosses into a wall cell.
+    // A target inside a wall is not visible, and neither is one seen exactly through a wall corner.
+    bool isClear(const WallRows& rows, const Query& q) noexcept;
+
+    // isClear() for every query, as a bitset: bit i of result is set if query i is clear. result needs (queries.size() + 63) / 64 words.
+    // With AVX2 this traces 8 segments per instruction and stops as soon as every segment in the batch has hit a wall or arrived.
+    void lineOfSight(const WallRows& rows, std::span<const Query> queries, std::span<uint64_t> result) noexcept;
+    const char* lineOfSightKernel() noexcept; //"avx2" or "scalar": which loop lineOfSight() was compiled with
+
+    template<auto IsWall>
+    void lineOfSight(std::span<const Query> queries, std::span<uint64_t> result) noexcept {
+        static constexpr auto rows = wallRows<IsWall>();
+        lineOfSight(rows, queries, result);
+    }
+
+    inline bool isVisible(std::span<const uint64_t> result, size_t index) noexcept { //read one answer from lineOfSight()
+        return (result[index >> 6] >> (index & 63)) & 1;
+    }
+}
+
+//the game's map
+inline void lineOfSight(std::span<const GridTraversal::Query> queries, std::span<uint64_t> result) noexcept {
+    GridTraversal::lineOfSight<isWall>(queries, result);
+}
@@ -0,0 +1,265 @@
+#include "HeapCounter.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "Profiler.h"
+#ifdef COUNT_HEAP_ALLOCATIONS
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#elif defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+namespace {
+	// Everything here runs inside operator new, so none of it may allocate: fixed tables, atomics and
+	// constant-initialized thread_locals only.
+	constexpr const char* NO_ZONE = "(no zone)";
+	constexpr size_t ZONES = 256; //distinct zones we can tell apart. Allocations in any more are only in the totals.
+	constexpr uint32_t MAX_CAPTURES = 8; //stacks kept per frame
+	constexpr int MAX_FRAMES = 24; //per stack
+
+	struct ZoneTally {
+		std::atomic<const char*> name{ nullptr }; //claimed once, kept across frames
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> bytes{ 0 };
+	};
+	constexpr uint64_t WRITING = UINT64_MAX;
+	struct Capture {
+		std::atomic<uint64_t> stamp{ 0 }; //the frame it was captured in, shifted left one, with the low bit set once written out. WRITING while taken.
+		const char* zone = nullptr;
+		size_t bytes = 0;
+		int depth = 0;
+		void* frames[MAX_FRAMES]{};
+	};
+
+	std::atomic<uint64_t> allocationCount{ 0 };
+	std::atomic<uint64_t> byteCount{ 0 };
+	std::array<ZoneTally, ZONES> zones;
+	std::array<Capture, MAX_CAPTURES> captures;
+	std::atomic<uint64_t> currentFrame{ 1 }; //bumped by beginFrame(). Captures from earlier frames are free to take.
+	std::atomic<bool> armed{ false };
+	thread_local bool busy = false; //this thread is inside the tracker: don't track the tracker
+
+	const char* currentZone() noexcept {
+#ifdef USE_PROFILER
+		const char* zone = Profiler::currentZone();
+		return zone ? zone : NO_ZONE;
+#else
+		return NO_ZONE;
+#endif
+	}
+
+	void charge(const char* zone, size_t bytes) noexcept {
+		const size_t home = (reinterpret_cast<uintptr_t>(zone) >> 3) & (ZONES - 1); //zone names are string literals: the address is the key
+		for (size_t probe = 0; probe < ZONES; probe++) {
+			auto& tally = zones[(home + probe) & (ZONES - 1)];
+			const char* name = tally.name.load(std::memory_order_acquire);
+			if (name == nullptr && tally.name.compare_exchange_strong(name, zone, std::memory_order_acq_rel)) {
+				name = zone;
+			}
+			if (name == zone) {
+				tally.allocations.fetch_add(1, std::memory_order_relaxed);
+				tally.bytes.fetch_add(bytes, std::memory_order_relaxed);
+				return;
+			}
+		}
+	}
+
+	int captureStack(void** frames, int max) noexcept {
+#if defined(_WIN32)
+		return CaptureStackBackTrace(1, static_cast<DWORD>(max), frames, nullptr);
+#elif defined(__GLIBC__)
+		return backtrace(frames, max);
+#else
+		(void)frames; (void)max;
+		return 0;
+#endif
+	}
+
+	constexpr uint64_t written(uint64_t generation) noexcept { return (generation << 1) | 1; }
+
+	// Take a slot no capture of this frame (or a later one) holds. Another thread may still be allocating when the next
+	// frame begins, so a slot is claimed with a compare-exchange: two threads never write one, and a thread that read an
+	// old frame number can only take slots older still, never one this frame's report() may be reading.
+	Capture* claimCapture(uint64_t generation) noexcept {
+		for (auto& c : captures) {
+			uint64_t stamp = c.stamp.load(std::memory_order_acquire);
+			if (stamp != WRITING && (stamp >> 1) < generation && c.stamp.compare_exchange_strong(stamp, WRITING, std::memory_order_acquire)) {
+				return &c;
+			}
+		}
+		return nullptr;
+	}
+
+	void record(size_t bytes) noexcept {
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		byteCount.fetch_add(bytes, std::memory_order_relaxed);
+		if (busy) { return; }
+		busy = true;
+		const char* zone = currentZone();
+		charge(zone, bytes);
+		if (armed.load(std::memory_order_relaxed)) {
+			const uint64_t generation = currentFrame.load(std::memory_order_acquire);
+			if (Capture* c = claimCapture(generation)) {
+				c->zone = zone;
+				c->bytes = bytes;
+				c->depth = captureStack(c->frames, MAX_FRAMES);
+				c->stamp.store(written(generation), std::memory_order_release);
+			}
+		}
+		busy = false;
+	}
+
+	void* allocate(size_t bytes) noexcept {
+		record(bytes);
+		return std::malloc(bytes == 0 ? 1 : bytes);
+	}
+	void* allocateAligned(size_t bytes, std::align_val_t alignment) noexcept {
+		record(bytes);
+		const auto align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+		return _aligned_malloc(bytes == 0 ? 1 : bytes, align);
+#else
+		return std::aligned_alloc(align, ((bytes == 0 ? 1 : bytes) + align - 1) & ~(align - 1)); //size must be a multiple of the alignment
+#endif
+	}
+	void freeAligned(void* p) noexcept {
+#ifdef _MSC_VER
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+	void* orThrow(void* p) {
+		if (!p) { throw std::bad_alloc(); }
+		return p;
+	}
+
+	void printStack(std::ostream& out, void* const* frames, int depth) {
+#if defined(_WIN32)
+		const HANDLE process = GetCurrentProcess();
+		static const bool symbols = [process] {
+			SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+			return SymInitialize(process, nullptr, TRUE) == TRUE;
+		}();
+		for (int i = 0; i < depth; i++) {
+			const auto address = reinterpret_cast<DWORD64>(frames[i]);
+			alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + 256]{};
+			auto* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+			symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+			symbol->MaxNameLen = 255;
+			DWORD64 displacement = 0;
+			out << "    " << frames[i];
+			if (symbols && SymFromAddr(process, address, &displacement, symbol)) {
+				out << " " << symbol->Name;
+				IMAGEHLP_LINE64 line{};
+				line.SizeOfStruct = sizeof(line);
+				DWORD line_displacement = 0;
+				if (SymGetLineFromAddr64(process, address, &line_displacement, &line)) {
+					out << " " << line.FileName << ":" << line.LineNumber;
+				}
+			}
+			out << "\n";
+		}
+#elif defined(__GLIBC__)
+		char** names = backtrace_symbols(frames, depth);
+		for (int i = 0; i < depth; i++) {
+			out << "    " << (names ? names[i] : "?") << "\n";
+		}
+		std::free(names);
+#else
+		(void)frames; (void)depth;
+		out << "    (no stack capture on this platform)\n";
+#endif
+	}
+}
+
+HeapCounter::Totals HeapCounter::totals() noexcept {
+	return Totals{ allocationCount.load(std::memory_order_relaxed), byteCount.load(std::memory_order_relaxed) };
+}
+uint64_t HeapCounter::allocations() noexcept {
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+HeapCounter::Totals HeapCounter::beginFrame() noexcept {
+	for (auto& tally : zones) {
+		tally.allocations.store(0, std::memory_order_relaxed);
+		tally.bytes.store(0, std::memory_order_relaxed);
+	}
+	currentFrame.fetch_add(1, std::memory_order_acq_rel); //this frame's captures start out empty; the old ones are free to reuse
+	return totals();
+}
+
+void HeapCounter::arm(bool on) noexcept {
+	armed.store(on, std::memory_order_relaxed);
+}
+
+void HeapCounter::report(std::ostream& out, const Totals& frame) {
+	busy = true; //our own allocations below aren't what we're looking for
+	out << "heap: " << frame.allocations << " allocations (" << frame.bytes << " bytes) this frame\n";
+	struct Row {
+		const char* zone;
+		uint64_t allocations, bytes;
+	};
+	std::vector<Row> rows;
+	for (const auto& tally : zones) {
+		const char* name = tally.name.load(std::memory_order_acquire);
+		const auto count = tally.allocations.load(std::memory_order_relaxed);
+		if (name && count > 0) {
+			rows.push_back(Row{ name, count, tally.bytes.load(std::memory_order_relaxed) });
+		}
+	}
+	std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.allocations > b.allocations; });
+	for (const auto& row : rows) {
+		out << "  " << row.zone << ": " << row.allocations << " allocations, " << row.bytes << " bytes\n";
+	}
+	const uint64_t generation = currentFrame.load(std::memory_order_acquire);
+	for (const auto& c : captures) {
+		if (c.stamp.load(std::memory_order_acquire) != written(generation)) { continue; } //another frame's, or still being written
+		out << "  " << c.bytes << " bytes in " << c.zone << ", from:\n";
+		printStack(out, c.frames, c.depth);
+	}
+	busy = false;
+}
+
+//every replaceable global new and delete, so nothing allocates uncounted, or frees through an allocator it wasn't allocated from
+void* operator new(size_t bytes) { return orThrow(allocate(bytes)); }
+void* operator new[](size_t bytes) { return orThrow(allocate(bytes)); }
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept { return allocate(bytes); }
+void* operator new[](size_t bytes, const std::nothrow_t&) noexcept { return allocate(bytes); }
+void* operator new(size_t bytes, std::align_val_t alignment) { return orThrow(allocateAligned(bytes, alignment)); }
+void* operator new[](size_t bytes, std::align_val_t alignment) { return orThrow(allocateAligned(bytes, alignment)); }
+void* operator new(size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(bytes, alignment); }
+void* operator new[](size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(bytes, alignment); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(p); }
+#else
+HeapCounter::Totals HeapCounter::totals() noexcept {
+	return Totals{};
+}
+uint64_t HeapCounter::allocations() noexcept {
+	return 0;
+}
+HeapCounter::Totals HeapCounter::beginFrame() noexcept {
+	return Totals{};
+}
+void HeapCounter::arm(bool) noexcept {}
+void HeapCounter::report(std::ostream&, const Totals&) {}
+#endif //COUNT_HEAP_ALLOCATIONS
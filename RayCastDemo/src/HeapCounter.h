@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include "Config.h"
+// Counts every global operator new, on every thread, to prove the main loop stops allocating once it has warmed up.
+// Opt-in: with COUNT_HEAP_ALLOCATIONS (see Config.h, on in debug builds) HeapCounter.cpp replaces the global operator new and delete.
+// Without it nothing is replaced, totals() is always zero and the rest does nothing.
+// Each allocation is also charged to the innermost PROFILE_ZONE open on its thread, and while armed (the steady state)
+// the first few get a stack trace, so report() can say who allocated and from where.
+namespace HeapCounter {
+	constexpr bool enabled() noexcept {
+#ifdef COUNT_HEAP_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	struct Totals {
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+		constexpr Totals operator-(const Totals& that) const noexcept {
+			return Totals{ allocations - that.allocations, bytes - that.bytes };
+		}
+	};
+	Totals totals() noexcept; //since startup, all threads
+	uint64_t allocations() noexcept;
+
+	// Start a frame: forget the zones and stacks recorded so far. Returns totals(), to subtract at the end of the frame.
+	Totals beginFrame() noexcept;
+	// Capture stacks of the allocations from here on. Costs a stack walk per allocation, so only arm it for the
+	// steady state, where there should be none.
+	void arm(bool on) noexcept;
+	// Print what allocated since beginFrame(): allocations and bytes per zone, then the captured stacks, symbolized.
+	// Allocates, so call it after the frame's totals are taken.
+	void report(std::ostream& out, const Totals& frame);
+
+	// Tallies the frames after warm-up that allocated anything. Feed it each frame's totals.
+	class SteadyStateCheck {
+		uint32_t _warmup = Cfg::ALLOCATION_WARMUP_FRAMES; //frames left to ignore: first-use setup, caches filling up
+		uint64_t _frames = 0;
+		uint64_t _dirtyFrames = 0;
+		Totals _total{};
+		Totals _worst{}; //the frame that allocated most often
+	public:
+		//returns true if this frame counts and allocated
+		bool endFrame(const Totals& frame) noexcept {
+			if (_warmup > 0) {
+				_warmup--;
+				return false;
+			}
+			_frames++;
+			if (frame.allocations == 0) { return false; }
+			_dirtyFrames++;
+			_total.allocations += frame.allocations;
+			_total.bytes += frame.bytes;
+			_worst = (frame.allocations > _worst.allocations) ? frame : _worst;
+			return true;
+		}
+		bool steady() const noexcept { //past warm-up
+			return _warmup == 0;
+		}
+		uint64_t dirtyFrames() const noexcept {
+			return _dirtyFrames;
+		}
+		void print(std::ostream& out) const {
+			out << "heap: " << _total.allocations << " allocations (" << _total.bytes << " bytes) in " << _frames << " steady-state frames";
+			if (_dirtyFrames > 0) {
+				out << " (" << _dirtyFrames << " frames allocated, at most " << _worst.allocations << " times / " << _worst.bytes << " bytes in one)";
+			}
+			out << "\n";
+		}
+	};
+}
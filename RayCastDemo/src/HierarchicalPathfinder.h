@@ -0,0 +1,600 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+#include "BitGrid.h"
+#include "Pathfinding.h"
+// HPA* (Botea, Mueller & Schaeffer): the grid is cut into square clusters. Where two clusters touch, every run of cells
+// open on both sides becomes an entrance: one or two pairs of abstract nodes, one on each side. Inside a cluster every
+// pair of nodes is joined by its shortest path cost, computed once. A query then searches the small abstract graph,
+// and only the legs an agent actually walks need refining into cells, each with a search bounded to one cluster.
+// On big maps the abstract graph is itself too big to search end to end, so there is a second level: square regions of
+// clusters, joined the same way by the entrance nodes on their edges. A query is one A* that moves entrance by entrance
+// inside the start's and goal's regions, and region edge by region edge through every other, so it never looks inside a
+// region it only crosses. The region edges it used are filled in afterwards, each with a search bounded to its region.
+// Paths are near optimal: they always pass through entrance cells, and the query's A* is weighted (see setWeight()),
+// since on big maps the plain distance heuristic leaves it searching a good part of the map. Edits only rebuild the
+// clusters they touch. Their regions go stale, and queries cross a stale region entrance by entrance until
+// rebuildRegions() gets to it.
+class HierarchicalPathfinder {
+public:
+	using Point = Pathfinding::Point;
+	static constexpr float UNREACHABLE = std::numeric_limits<float>::infinity();
+
+private:
+	static constexpr float EPSILON = 1e-3f; //path costs are sums of floats
+	static constexpr int LONG_ENTRANCE = 6; //runs at least this long get a transition at both ends instead of one in the middle
+
+	// Dijkstra bounded to one cluster's rectangle. load() copies the rectangle's cells into a byte mask with a blocked
+	// border, so stepping never needs a bounds check. Every step costs at least 1, so the open list can be buckets
+	// one unit wide (Dial): nothing in a bucket can improve anything else in it, and no heap is needed.
+	// A step costs at most sqrt(2), so three buckets in a ring cover everything still open.
+	class LocalSearch {
+		int _left = 0, _top = 0, _width = 0, _height = 0;
+		int _stride = 0; //_width + 2
+		std::vector<uint8_t> _passable; //padded
+		std::vector<float> _g;
+		std::vector<int> _parent;
+		std::array<std::vector<int>, 3> _buckets;
+
+		bool inside(const Point& p) const noexcept {
+			return p.x >= _left && p.x < _left + _width && p.y >= _top && p.y < _top + _height;
+		}
+		int local(const Point& p) const noexcept { return (p.y - _top + 1) * _stride + (p.x - _left + 1); }
+		Point global(int cell) const noexcept { return { _left + cell % _stride - 1, _top + cell / _stride - 1 }; }
+
+	public:
+		void load(const BitGrid& grid, int left, int top, int right, int bottom) {
+			_left = left;
+			_top = top;
+			_width = right - left;
+			_height = bottom - top;
+			_stride = _width + 2;
+			const auto cells = static_cast<size_t>(_stride) * (_height + 2);
+			_passable.assign(cells, 0);
+			_g.resize(cells);
+			_parent.resize(cells);
+			for (int y = top; y < bottom; y++) {
+				for (int x = left; x < right; x++) {
+					_passable[local({ x, y })] = grid.isOpen(x, y);
+				}
+			}
+		}
+		// settle every cell reachable from source without leaving the rectangle, or stop early once target is settled
+		void run(const Point& source, const Point* target = nullptr) {
+			std::fill(_g.begin(), _g.end(), UNREACHABLE);
+			for (auto& bucket : _buckets) { bucket.clear(); }
+			const int stop = target ? local(*target) : -1;
+			const int s = local(source);
+			_g[s] = 0.0f;
+			_parent[s] = -1;
+			_buckets[0].push_back(s);
+			const int straight[4] = { -1, 1, -_stride, _stride };
+			for (int k = 0, empty = 0; empty < 3; k++) {
+				auto& bucket = _buckets[k % 3];
+				empty = bucket.empty() ? empty + 1 : 0;
+				for (size_t i = 0; i < bucket.size(); i++) { //relaxing only appends to the next two buckets
+					const int c = bucket[i];
+					const float g = _g[c];
+					if (static_cast<int>(g) != k) { continue; } //improved since, and moved to a lower bucket
+					if (c == stop) { return; }
+					auto relax = [&](int next, float cost) {
+						if (g + cost >= _g[next]) { return; }
+						_g[next] = g + cost;
+						_parent[next] = c;
+						_buckets[static_cast<int>(g + cost) % 3].push_back(next);
+					};
+					for (const int d : straight) {
+						if (_passable[c + d]) { relax(c + d, 1.0f); }
+					}
+					for (const int dx : { -1, 1 }) { //diagonals, no corner cutting
+						for (const int dy : { -_stride, _stride }) {
+							if (_passable[c + dx + dy] & _passable[c + dx] & _passable[c + dy]) { relax(c + dx + dy, Pathfinding::DIAGONAL_COST); } //&: the branches mispredict
+						}
+					}
+				}
+				bucket.clear();
+			}
+		}
+		float cost(const Point& p) const noexcept { return inside(p) ? _g[local(p)] : UNREACHABLE; }
+		//append the cells after the source, up to and including to
+		void appendPath(const Point& to, std::vector<Point>& out) const {
+			const auto first = out.size();
+			for (int c = local(to); _parent[c] != -1; c = _parent[c]) {
+				out.push_back(global(c));
+			}
+			std::reverse(out.begin() + first, out.end());
+		}
+	};
+
+	struct Entrance {
+		Point cell[2]; //side 0 is the left / upper cluster, side 1 the right / lower one
+		int local[2]{}; //index among each cluster's nodes
+	};
+	struct Border {
+		int cluster[2]{};
+		bool vertical = false; //a vertical line between a cluster and the one to its right
+		std::vector<Entrance> entrances;
+		bool dirty = true;
+	};
+	struct Edge {
+		int node = 0;
+		float cost = 0.0f;
+		bool operator==(const Edge&) const = default;
+	};
+	struct Cluster {
+		int left = 0, top = 0, right = 0, bottom = 0; //right and bottom exclusive
+		std::vector<int> borders; //up to 4
+		std::vector<int> nodes; //node ids, see nodeId()
+		std::vector<int> first; //nodes.size() + 1 offsets into edges
+		std::vector<Edge> edges; //by source node: the shortest paths inside the cluster, minus those through another node
+		bool dirty = true;
+	};
+
+	struct Region {
+		int left = 0, top = 0, right = 0, bottom = 0; //in clusters, right and bottom exclusive
+		std::vector<int> nodes; //the entrance nodes on its edge, on its side: where paths leave it
+		std::vector<int> first;
+		std::vector<Edge> edges; //by source node: the shortest entrance paths inside the region, minus those through another node
+		bool dirty = true; //stale: its clusters changed since its edges were found
+	};
+
+	//search state, indexed by node id. Two extra slots for the start and the goal.
+	struct Node {
+		float g = 0.0f;
+		int parent = -1;
+		uint32_t stamp = 0;
+		bool closed = false;
+		bool coarse = false; //reached over a region edge: the entrances in between are still to be filled in
+	};
+	struct Open {
+		float f = 0.0f;
+		float g = 0.0f;
+		int node = 0;
+		bool operator>(const Open& that) const noexcept { //lowest f first, then the deepest node
+			return f > that.f || (f == that.f && g < that.g);
+		}
+	};
+	struct Search {
+		std::vector<Node> nodes;
+		std::vector<Open> open;
+		uint32_t now = 0;
+		float weight = 1.0f; //of the heuristic. Only queries search weighted: building and filling in region edges needs exact costs.
+		void begin(float heuristic_weight = 1.0f) {
+			if (++now == 0) {
+				std::fill(nodes.begin(), nodes.end(), Node{});
+				now = 1;
+			}
+			open.clear();
+			weight = heuristic_weight;
+		}
+	};
+
+	BitGrid& _grid;
+	int _size = 0; //cluster width and height, in cells
+	int _columns = 0, _rows = 0; //clusters
+	int _maxEntrances = 0; //per border
+	int _regionSize = 0; //region width and height, in clusters
+	int _regionColumns = 0, _regionRows = 0;
+	float _weight = 1.0f;
+	std::vector<Cluster> _clusters;
+	std::vector<Border> _borders;
+	std::vector<Region> _regions;
+	std::vector<int> _regionLocal; //per node: its index among its region's nodes, -1 if it isn't on the region's edge
+	LocalSearch _local;
+	std::vector<float> _cost; //scratch for building a cluster or region: all pairs of its nodes
+	std::vector<int> _oldFirst; //scratch: a cluster's edges before it was rebuilt
+	std::vector<Edge> _oldEdges;
+	LocalSearch _localGoal; //kept alive during a query: distances from the goal to its cluster's nodes
+	Search _search;
+	struct Step {
+		int node = 0;
+		bool coarse = false;
+	};
+	std::vector<Step> _chain; //the last path found, goal first
+	int _expanded = 0;
+
+	int nodeId(int border, int entrance, int side) const noexcept { return (border * _maxEntrances + entrance) * 2 + side; }
+	const Entrance& entranceOf(int node) const noexcept { return _borders[node / 2 / _maxEntrances].entrances[node / 2 % _maxEntrances]; }
+	Point cellOf(int node) const noexcept { return entranceOf(node).cell[node & 1]; }
+	int clusterOf(int node) const noexcept { return _borders[node / 2 / _maxEntrances].cluster[node & 1]; }
+	int clusterAt(const Point& p) const noexcept { return (p.y / _size) * _columns + (p.x / _size); }
+	int regionOf(int cluster) const noexcept { return (cluster / _columns / _regionSize) * _regionColumns + (cluster % _columns) / _regionSize; }
+	int startNode() const noexcept { return static_cast<int>(_search.nodes.size()) - 2; }
+	int goalNode() const noexcept { return static_cast<int>(_search.nodes.size()) - 1; }
+
+	void buildEntrances(Border& border) {
+		border.entrances.clear();
+		const auto& a = _clusters[border.cluster[0]];
+		//walk along the shared edge. For a vertical border that's down the column pair (right edge of a, left edge of b)
+		const int length = border.vertical ? a.bottom - a.top : a.right - a.left;
+		auto sides = [&](int i) {
+			return border.vertical ? std::pair{ Point{ a.right - 1, a.top + i }, Point{ a.right, a.top + i } }
+				: std::pair{ Point{ a.left + i, a.bottom - 1 }, Point{ a.left + i, a.bottom } };
+		};
+		auto addEntrance = [&](int i) {
+			const auto [first, second] = sides(i);
+			border.entrances.push_back({ { first, second } });
+		};
+		for (int i = 0; i < length; ) {
+			const auto [first, second] = sides(i);
+			if (!_grid.isOpen(first.x, first.y) || !_grid.isOpen(second.x, second.y)) {
+				i++;
+				continue;
+			}
+			int end = i + 1;
+			while (end < length) {
+				const auto [f, s] = sides(end);
+				if (!_grid.isOpen(f.x, f.y) || !_grid.isOpen(s.x, s.y)) { break; }
+				end++;
+			}
+			if (end - i >= LONG_ENTRANCE) {
+				addEntrance(i);
+				addEntrance(end - 1);
+			}
+			else {
+				addEntrance((i + end - 1) / 2);
+			}
+			i = end;
+		}
+		assert(static_cast<int>(border.entrances.size()) <= _maxEntrances);
+		border.dirty = false;
+	}
+
+	//edges from _cost, the costs between every pair of nodes: all of them but the ones no shorter than going through
+	//some third node, since the search gets there through it at the same cost. Both halves must be non-zero, or two
+	//nodes on the same cell would each excuse the other's edge.
+	void link(const std::vector<int>& nodes, std::vector<int>& first, std::vector<Edge>& edges) const {
+		const auto n = nodes.size();
+		auto redundant = [&](size_t i, size_t j) {
+			const float direct = _cost[i * n + j];
+			for (size_t k = 0; k < n; k++) {
+				const float a = _cost[i * n + k], b = _cost[k * n + j];
+				if (k != i && k != j && a > 0.0f && b > 0.0f && a + b <= direct + EPSILON) { return true; }
+			}
+			return false;
+		};
+		first.assign(1, 0);
+		edges.clear();
+		for (size_t i = 0; i < n; i++) {
+			for (size_t j = 0; j < n; j++) {
+				if (i != j && _cost[i * n + j] != UNREACHABLE && !redundant(i, j)) { edges.push_back({ nodes[j], _cost[i * n + j] }); }
+			}
+			first.push_back(static_cast<int>(edges.size()));
+		}
+	}
+
+	//returns whether its edges changed. Its nodes only change with its borders' entrances.
+	bool buildCluster(int index) {
+		auto& cluster = _clusters[index];
+		_oldFirst.swap(cluster.first);
+		_oldEdges.swap(cluster.edges);
+		cluster.nodes.clear();
+		for (const int b : cluster.borders) {
+			auto& border = _borders[b];
+			const int side = (border.cluster[0] == index) ? 0 : 1;
+			for (int e = 0; e < static_cast<int>(border.entrances.size()); e++) {
+				border.entrances[e].local[side] = static_cast<int>(cluster.nodes.size());
+				cluster.nodes.push_back(nodeId(b, e, side));
+			}
+		}
+		const auto n = cluster.nodes.size();
+		_cost.assign(n * n, UNREACHABLE);
+		_local.load(_grid, cluster.left, cluster.top, cluster.right, cluster.bottom);
+		for (size_t i = 0; i < n; i++) {
+			_local.run(cellOf(cluster.nodes[i]));
+			for (size_t j = 0; j < n; j++) {
+				_cost[i * n + j] = _local.cost(cellOf(cluster.nodes[j]));
+			}
+		}
+		link(cluster.nodes, cluster.first, cluster.edges);
+		cluster.dirty = false;
+		return cluster.first != _oldFirst || cluster.edges != _oldEdges;
+	}
+
+	//needs its clusters built
+	void buildRegion(int index) {
+		auto& region = _regions[index];
+		for (const int node : region.nodes) { _regionLocal[node] = -1; } //entrances may have come and gone
+		region.nodes.clear();
+		for (int cy = region.top; cy < region.bottom; cy++) {
+			for (int cx = region.left; cx < region.right; cx++) {
+				const int c = cy * _columns + cx;
+				for (const int b : _clusters[c].borders) {
+					const auto& border = _borders[b];
+					const int side = (border.cluster[0] == c) ? 0 : 1;
+					if (regionOf(border.cluster[side ^ 1]) == index) { continue; } //inside the region
+					for (int e = 0; e < static_cast<int>(border.entrances.size()); e++) {
+						_regionLocal[nodeId(b, e, side)] = static_cast<int>(region.nodes.size());
+						region.nodes.push_back(nodeId(b, e, side));
+					}
+				}
+			}
+		}
+		const auto n = region.nodes.size();
+		_cost.assign(n * n, UNREACHABLE);
+		for (size_t i = 0; i < n; i++) {
+			_cost[i * n + i] = 0.0f;
+			//costs are symmetric, so the searches from earlier nodes already found the way back to them
+			const Point from = cellOf(region.nodes[i]);
+			_search.begin();
+			push(region.nodes[i], 0.0f, -1, from);
+			for (size_t wanted = n - 1 - i; wanted > 0 && !_search.open.empty();) {
+				const int node = pop();
+				auto& reached = _search.nodes[node];
+				if (reached.closed) { continue; }
+				reached.closed = true;
+				const int j = _regionLocal[node];
+				if (j > static_cast<int>(i)) {
+					_cost[i * n + j] = _cost[j * n + i] = reached.g;
+					wanted--;
+				}
+				expand(node, index, -1, -1, -1, from);
+			}
+		}
+		link(region.nodes, region.first, region.edges);
+		region.dirty = false;
+	}
+
+	void push(int node, float g, int parent, const Point& goal, bool coarse = false) {
+		auto& n = _search.nodes[node];
+		if (n.stamp != _search.now) { n = { UNREACHABLE, -1, _search.now, false }; }
+		if (n.closed || n.g <= g) { return; }
+		n.g = g;
+		n.parent = parent;
+		n.coarse = coarse;
+		const Point p = (node == goalNode()) ? goal : cellOf(node);
+		_search.open.push_back({ g + _search.weight * Pathfinding::octile(p, goal), g, node });
+		std::push_heap(_search.open.begin(), _search.open.end(), std::greater<>{});
+	}
+	int pop() {
+		std::pop_heap(_search.open.begin(), _search.open.end(), std::greater<>{});
+		const int node = _search.open.back().node;
+		_search.open.pop_back();
+		return node;
+	}
+
+	//The neighbours of node: its partner across the border, and then either the other nodes of its cluster, or, in a region
+	//the query only crosses and that isn't stale, the other nodes of its region. Plus the goal, from the goal's cluster.
+	//Bounded to region (>= 0), it never leaves that region and never takes region edges: for building one, or filling one in.
+	void expand(int node, int region, int start_region, int goal_region, int goal_cluster, const Point& goal) {
+		const float g = _search.nodes[node].g;
+		if (region < 0 || regionOf(clusterOf(node ^ 1)) == region) {
+			push(node ^ 1, g + 1.0f, node, goal); //the partner is the orthogonal neighbour across the border
+		}
+		const int c = clusterOf(node);
+		const int r = regionOf(c);
+		if (region < 0 && r != start_region && r != goal_region && !_regions[r].dirty) { //only ever entered across its edge, so node is one of its nodes
+			const auto& through = _regions[r];
+			const int i = _regionLocal[node];
+			assert(i >= 0 && "HierarchicalPathfinder: inside a region the query only crosses");
+			for (int e = through.first[i]; e < through.first[i + 1]; e++) {
+				push(through.edges[e].node, g + through.edges[e].cost, node, goal, true);
+			}
+			return;
+		}
+		const auto& cluster = _clusters[c];
+		const int i = entranceOf(node).local[node & 1];
+		for (int e = cluster.first[i]; e < cluster.first[i + 1]; e++) {
+			push(cluster.edges[e].node, g + cluster.edges[e].cost, node, goal);
+		}
+		if (c == goal_cluster) {
+			const float to_goal = _localGoal.cost(cellOf(node));
+			if (to_goal != UNREACHABLE) { push(goalNode(), g + to_goal, node, goal); }
+		}
+	}
+
+	// Run the search from what was pushed since _search.begin(), bounded to region (-1: the whole map at both levels, see
+	// expand()). Returns true once target is closed.
+	bool searchEntrances(int region, int target, const Point& goal, int start_region = -1, int goal_region = -1, int goal_cluster = -1) {
+		while (!_search.open.empty()) {
+			const int node = pop();
+			auto& n = _search.nodes[node];
+			if (n.closed) { continue; }
+			n.closed = true;
+			_expanded++;
+			if (node == target) { return true; }
+			expand(node, region, start_region, goal_region, goal_cluster, goal);
+		}
+		return false;
+	}
+
+	//a search from start, through its cluster's nodes, and straight to the goal if it's in the same cluster. Needs _local run from start.
+	void seedStart(int start_cluster, int goal_cluster, const Point& goal) {
+		_search.begin(_weight);
+		_search.nodes[startNode()] = { 0.0f, -1, _search.now, true };
+		for (const int node : _clusters[start_cluster].nodes) {
+			const float cost = _local.cost(cellOf(node));
+			if (cost != UNREACHABLE) { push(node, cost, startNode(), goal); }
+		}
+		if (start_cluster == goal_cluster && _local.cost(goal) != UNREACHABLE) {
+			push(goalNode(), _local.cost(goal), startNode(), goal);
+		}
+	}
+
+	//append the cells of the nodes the entrance search reached last through, after the one it started from
+	void appendEntrancePath(int last, const Point& goal, std::vector<Point>& waypoints) const {
+		const auto first = waypoints.size();
+		for (int node = last; _search.nodes[node].parent != -1; node = _search.nodes[node].parent) {
+			waypoints.push_back(node == goalNode() ? goal : cellOf(node));
+		}
+		std::reverse(waypoints.begin() + first, waypoints.end());
+	}
+
+public:
+	// grid is referenced, not copied. Edit it through setOpen(), so the abstraction can follow.
+	// region_size is in clusters: 4 queries 4096x4096 as fast as 8, at a fifth of the cost per region rebuilt.
+	HierarchicalPathfinder(BitGrid& grid, int cluster_size = 32, int region_size = 4, float weight = 1.2f) : _grid(grid), _size(cluster_size), _regionSize(region_size) {
+		assert(cluster_size >= 2 && region_size >= 1);
+		setWeight(weight);
+		_columns = (grid.width() + _size - 1) / _size;
+		_rows = (grid.height() + _size - 1) / _size;
+		_maxEntrances = (_size + 1) / 2; //runs are at least one blocked cell apart
+		_clusters.resize(static_cast<size_t>(_columns) * _rows);
+		for (int cy = 0; cy < _rows; cy++) {
+			for (int cx = 0; cx < _columns; cx++) {
+				auto& c = _clusters[cy * _columns + cx];
+				c.left = cx * _size;
+				c.top = cy * _size;
+				c.right = std::min(c.left + _size, grid.width());
+				c.bottom = std::min(c.top + _size, grid.height());
+			}
+		}
+		auto addBorder = [&](int a, int b, bool vertical) {
+			_clusters[a].borders.push_back(static_cast<int>(_borders.size()));
+			_clusters[b].borders.push_back(static_cast<int>(_borders.size()));
+			_borders.push_back({ { a, b }, vertical, {} });
+		};
+		for (int cy = 0; cy < _rows; cy++) {
+			for (int cx = 0; cx < _columns; cx++) {
+				if (cx + 1 < _columns) { addBorder(cy * _columns + cx, cy * _columns + cx + 1, true); }
+				if (cy + 1 < _rows) { addBorder(cy * _columns + cx, (cy + 1) * _columns + cx, false); }
+			}
+		}
+		_regionColumns = (_columns + _regionSize - 1) / _regionSize;
+		_regionRows = (_rows + _regionSize - 1) / _regionSize;
+		_regions.resize(static_cast<size_t>(_regionColumns) * _regionRows);
+		for (int ry = 0; ry < _regionRows; ry++) {
+			for (int rx = 0; rx < _regionColumns; rx++) {
+				auto& r = _regions[ry * _regionColumns + rx];
+				r.left = rx * _regionSize;
+				r.top = ry * _regionSize;
+				r.right = std::min(r.left + _regionSize, _columns);
+				r.bottom = std::min(r.top + _regionSize, _rows);
+			}
+		}
+		const auto nodes = _borders.size() * _maxEntrances * 2 + 2;
+		_search.nodes.resize(nodes);
+		_regionLocal.assign(nodes, -1);
+		rebuildRegions();
+	}
+
+	// Paths found cost at most weight times the best one through entrances. 1 finds that one, but on 4096x4096 rooms
+	// its slowest queries take ~50 ms: going round walls makes paths ~10% longer than the straight line, and A* searches
+	// every node that much off the way, a good part of the map. 1.2 keeps them under ~2 ms, for paths ~4% longer.
+	void setWeight(float weight) noexcept {
+		assert(weight >= 1.0f);
+		_weight = weight;
+	}
+
+	void setOpen(int x, int y, bool open) noexcept {
+		if (_grid.isOpen(x, y) == open) { return; }
+		_grid.setOpen(x, y, open);
+		auto& cluster = _clusters[clusterAt({ x, y })];
+		cluster.dirty = true;
+		for (const int b : cluster.borders) { //a cell on the cluster's edge can open or close an entrance
+			auto& border = _borders[b];
+			const auto& a = _clusters[border.cluster[0]];
+			const bool on_edge = border.vertical ? (x == a.right - 1 || x == a.right) : (y == a.bottom - 1 || y == a.bottom);
+			if (on_edge) { border.dirty = true; }
+		}
+	}
+
+	//rebuild the clusters setOpen() touched. Called by find(), call it yourself to control when the cost is paid.
+	//Their regions only go stale, see rebuildRegions().
+	void update() {
+		for (auto& border : _borders) {
+			if (!border.dirty) { continue; }
+			buildEntrances(border);
+			for (const int c : border.cluster) {
+				_clusters[c].dirty = true;
+				_regions[regionOf(c)].dirty = true;
+			}
+		}
+		for (int c = 0; c < static_cast<int>(_clusters.size()); c++) {
+			if (_clusters[c].dirty && buildCluster(c)) { _regions[regionOf(c)].dirty = true; } //an edit that changes no cost between entrances leaves its region as it was
+		}
+	}
+
+	//rebuild up to max stale regions, each about as costly as a few dozen clusters. Until then queries search more nodes
+	//through them, for paths within the same bound: the same paths at weight 1. Returns how many are still stale.
+	int rebuildRegions(int max = std::numeric_limits<int>::max()) {
+		update(); //regions are built from their clusters
+		int stale = 0;
+		for (int r = 0; r < static_cast<int>(_regions.size()); r++) {
+			if (!_regions[r].dirty) { continue; }
+			if (max > 0) {
+				buildRegion(r);
+				max--;
+			}
+			else {
+				stale++;
+			}
+		}
+		return stale;
+	}
+
+	// The abstract path: start, the entrance cells it passes through, goal. Consecutive waypoints are either
+	// neighbours across a border, or in the same cluster; refine() turns one leg into cells.
+	bool find(const Point& start, const Point& goal, std::vector<Point>& waypoints) {
+		waypoints.clear();
+		_expanded = 0;
+		if (!_grid.isOpen(start.x, start.y) || !_grid.isOpen(goal.x, goal.y)) { return false; }
+		update();
+		const int start_cluster = clusterAt(start);
+		const int goal_cluster = clusterAt(goal);
+		const int start_region = regionOf(start_cluster);
+		const int goal_region = regionOf(goal_cluster);
+		const auto& sc = _clusters[start_cluster];
+		const auto& gc = _clusters[goal_cluster];
+		_localGoal.load(_grid, gc.left, gc.top, gc.right, gc.bottom);
+		_localGoal.run(goal);
+		_local.load(_grid, sc.left, sc.top, sc.right, sc.bottom);
+		_local.run(start);
+		seedStart(start_cluster, goal_cluster, goal);
+		if (!searchEntrances(-1, goalNode(), goal, start_region, goal_region, goal_cluster)) { return false; }
+		_chain.clear();
+		for (int node = goalNode(); node != startNode(); node = _search.nodes[node].parent) {
+			_chain.push_back({ node, _search.nodes[node].coarse });
+		}
+		//the entrance cells, filling in the region edges with a search inside the region
+		waypoints.push_back(start);
+		for (size_t k = _chain.size(); k-- > 0;) {
+			const int node = _chain[k].node;
+			if (!_chain[k].coarse) {
+				waypoints.push_back(node == goalNode() ? goal : cellOf(node));
+				continue;
+			}
+			const int from = _chain[k + 1].node; //a region edge never starts at the start
+			_search.begin();
+			push(from, 0.0f, -1, cellOf(node));
+			[[maybe_unused]] const bool joined = searchEntrances(regionOf(clusterOf(from)), node, cellOf(node));
+			assert(joined && "HierarchicalPathfinder: a region edge with no entrance path behind it");
+			appendEntrancePath(node, goal, waypoints);
+		}
+		return true;
+	}
+
+	//append the cells of the leg from waypoint a to waypoint b, after a, up to and including b
+	void refine(const Point& a, const Point& b, std::vector<Point>& cells) {
+		if (clusterAt(a) != clusterAt(b)) { //across a border: one step
+			cells.push_back(b);
+			return;
+		}
+		const auto& c = _clusters[clusterAt(a)];
+		_local.load(_grid, c.left, c.top, c.right, c.bottom);
+		_local.run(a, &b);
+		assert(_local.cost(b) != UNREACHABLE && "HierarchicalPathfinder: refine() needs two waypoints of the same path");
+		_local.appendPath(b, cells);
+	}
+
+	//find() and refine() every leg: every cell from start to goal
+	bool findPath(const Point& start, const Point& goal, std::vector<Point>& waypoints, std::vector<Point>& cells) {
+		cells.clear();
+		if (!find(start, goal, waypoints)) { return false; }
+		cells.push_back(start);
+		for (size_t i = 1; i < waypoints.size(); i++) {
+			refine(waypoints[i - 1], waypoints[i], cells);
+		}
+		return true;
+	}
+
+	int expanded() const noexcept { return _expanded; } //nodes taken off the open lists by the last find(), both levels
+	int clusterSize() const noexcept { return _size; }
+	int regionSize() const noexcept { return _regionSize; }
+	float weight() const noexcept { return _weight; }
+};
@@ -0,0 +1,230 @@
+#include "IndexedFrameBuffer.h"
+#include "SDLSystem.h"
+#include "Renderer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HAS_AVX2_EXPAND
+#endif
+#if defined(__SSSE3__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#include <tmmintrin.h>
+#define HAS_SSSE3_EXPAND
+#endif
+
+namespace {
+	//ARGB8888 is stored B, G, R, A in memory (little endian). We split the palette into one 16-byte table per channel,
+	//so a single pshufb can translate 16 indices for one channel at a time.
+	struct PalettePlanes {
+		alignas(16) Uint8 b[16]{}, g[16]{}, r[16]{}, a[16]{};
+	};
+
+	void expandRow(const Uint8* src, Uint32* out, int count, const Uint32* palette, [[maybe_unused]] const PalettePlanes* planes) noexcept {
+		int i = 0;
+#ifdef HAS_SSSE3_EXPAND
+		if (planes) { //only valid when the palette has <= 16 entries, since pshufb only looks at the low nibble of each index
+			const __m128i pb = _mm_load_si128(reinterpret_cast<const __m128i*>(planes->b));
+			const __m128i pg = _mm_load_si128(reinterpret_cast<const __m128i*>(planes->g));
+			const __m128i pr = _mm_load_si128(reinterpret_cast<const __m128i*>(planes->r));
+			const __m128i pa = _mm_load_si128(reinterpret_cast<const __m128i*>(planes->a));
+			for (; i + 16 <= count; i += 16) {
+				const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				const __m128i b = _mm_shuffle_epi8(pb, idx);
+				const __m128i g = _mm_shuffle_epi8(pg, idx);
+				const __m128i r = _mm_shuffle_epi8(pr, idx);
+				const __m128i a = _mm_shuffle_epi8(pa, idx);
+				const __m128i bg_lo = _mm_unpacklo_epi8(b, g);
+				const __m128i bg_hi = _mm_unpackhi_epi8(b, g);
+				const __m128i ra_lo = _mm_unpacklo_epi8(r, a);
+				const __m128i ra_hi = _mm_unpackhi_epi8(r, a);
+				auto* dst = reinterpret_cast<__m128i*>(out + i);
+				_mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(bg_lo, ra_lo));
+				_mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(bg_lo, ra_lo));
+				_mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(bg_hi, ra_hi));
+				_mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(bg_hi, ra_hi));
+			}
+		}
+#endif
+#ifdef HAS_AVX2_EXPAND
+		for (; i + 8 <= count; i += 8) { //full 256-entry palettes: widen 8 indices to 32 bit and gather
+			const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+			const __m256i idx = _mm256_cvtepu8_epi32(bytes);
+			const __m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int*>(palette), idx, 4);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), pixels);
+		}
+#endif
+		for (; i < count; i++) {
+			out[i] = palette[src[i]];
+		}
+	}
+}
+
+IndexedFrameBuffer::IndexedFrameBuffer(int width, int height, const Renderer* r) :
+	_width(width), _height(height), _pixels(static_cast<size_t>(width) * height, 0) {
+	assert(width > 0 && height > 0);
+	if (r) {
+		_texture.reset(SDL_CreateTexture(r->getRawPtr(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height));
+		if (!_texture) {
+			throw SDLError();
+		}
+	}
+}
+
+void IndexedFrameBuffer::setPalette(std::span<const SDL_Color> colors) noexcept {
+	assert(colors.size() <= MAX_COLORS && "IndexedFrameBuffer: too many colors for an 8-bit palette.");
+	_paletteSize = static_cast<int>(std::min<size_t>(colors.size(), MAX_COLORS));
+	for (int i = 0; i < _paletteSize; i++) {
+		setPaletteEntry(i, colors[i]);
+	}
+}
+
+void IndexedFrameBuffer::setPaletteEntry(int index, const SDL_Color& c) noexcept {
+	assert(index >= 0 && index < MAX_COLORS);
+	//alpha is forced opaque; several of our palette constants leave it zero-initialized.
+	_palette[index] = (0xFFu << 24) | (Uint32{ c.r } << 16) | (Uint32{ c.g } << 8) | Uint32{ c.b };
+	_paletteSize = std::max(_paletteSize, index + 1);
+}
+
+void IndexedFrameBuffer::cyclePalette(int first, int count, int step) noexcept {
+	assert(first >= 0 && count >= 0 && first + count <= MAX_COLORS);
+	if (count < 2) { return; }
+	step %= count;
+	if (step < 0) { step += count; }
+	const auto begin = std::begin(_palette) + first;
+	std::rotate(begin, begin + (count - step), begin + count);
+}
+
+void IndexedFrameBuffer::clear(PaletteIndex index) noexcept {
+	std::fill(_pixels.begin(), _pixels.end(), index);
+}
+
+void IndexedFrameBuffer::setPixel(int x, int y) noexcept {
+	if (isInside(x, y)) {
+		_pixels[y * _width + x] = _color;
+	}
+}
+
+void IndexedFrameBuffer::drawVerticalLine(int x, int y1, int y2) noexcept { //inclusive, like SDL_RenderDrawLine
+	if (x < 0 || x >= _width) { return; }
+	if (y1 > y2) { std::swap(y1, y2); }
+	y1 = std::max(y1, 0);
+	y2 = std::min(y2, _height - 1);
+	if (y1 > y2) { return; } //wholly above or below the buffer
+	auto* dst = &_pixels[y1 * _width + x];
+	for (int y = y1; y <= y2; y++, dst += _width) {
+		*dst = _color;
+	}
+}
+
+void IndexedFrameBuffer::drawLine(int x1, int y1, int x2, int y2) noexcept { //Bresenham, inclusive end points
+	if (x1 == x2) {
+		return drawVerticalLine(x1, y1, y2);
+	}
+	const int dx = std::abs(x2 - x1);
+	const int dy = -std::abs(y2 - y1);
+	const int sx = (x1 < x2) ? 1 : -1;
+	const int sy = (y1 < y2) ? 1 : -1;
+	int err = dx + dy;
+	while (true) {
+		setPixel(x1, y1);
+		if (x1 == x2 && y1 == y2) { break; }
+		const int e2 = 2 * err;
+		if (e2 >= dy) { err += dy; x1 += sx; }
+		if (e2 <= dx) { err += dx; y1 += sy; }
+	}
+}
+
+void IndexedFrameBuffer::drawFilledRect(const SDL_Rect& rect) noexcept {
+	const int left = std::max(rect.x, 0);
+	const int right = std::min(rect.x + rect.w, _width);
+	const int top = std::max(rect.y, 0);
+	const int bottom = std::min(rect.y + rect.h, _height);
+	if (left >= right) { return; }
+	for (int y = top; y < bottom; y++) {
+		std::fill_n(&_pixels[y * _width + left], right - left, _color);
+	}
+}
+
+void IndexedFrameBuffer::scrollRegion(const SDL_Rect& rect, int dx) noexcept {
+	const int left = std::max(rect.x, 0);
+	const int right = std::min(rect.x + rect.w, _width);
+	const int top = std::max(rect.y, 0);
+	const int bottom = std::min(rect.y + rect.h, _height);
+	const int count = (right - left) - std::abs(dx); //pixels per row that stay inside the region
+	if (dx == 0 || count <= 0) { return; }
+	const int from = (dx > 0) ? left : left - dx;
+	const int to = from + dx;
+	for (int y = top; y < bottom; y++) {
+		auto* row = &_pixels[y * _width];
+		std::memmove(row + to, row + from, count); //regions overlap
+	}
+}
+
+void IndexedFrameBuffer::drawRect(const SDL_Rect& rect) noexcept {
+	if (rect.w <= 0 || rect.h <= 0) { return; }
+	const int right = rect.x + rect.w - 1;
+	const int bottom = rect.y + rect.h - 1;
+	drawLine(rect.x, rect.y, right, rect.y);
+	drawLine(rect.x, bottom, right, bottom);
+	drawVerticalLine(rect.x, rect.y, bottom);
+	drawVerticalLine(right, rect.y, bottom);
+}
+
+void IndexedFrameBuffer::expand(Uint32* dst, int pitch) const noexcept {
+	PalettePlanes planes;
+	const PalettePlanes* use_planes = nullptr;
+	if (_paletteSize <= 16) {
+		for (int i = 0; i < 16; i++) {
+			planes.b[i] = static_cast<Uint8>(_palette[i]);
+			planes.g[i] = static_cast<Uint8>(_palette[i] >> 8);
+			planes.r[i] = static_cast<Uint8>(_palette[i] >> 16);
+			planes.a[i] = static_cast<Uint8>(_palette[i] >> 24);
+		}
+		use_planes = &planes;
+	}
+	for (int y = 0; y < _height; y++) {
+		auto* row = reinterpret_cast<Uint32*>(reinterpret_cast<Uint8*>(dst) + static_cast<size_t>(y) * pitch);
+		expandRow(&_pixels[y * _width], row, _width, _palette.data(), use_planes);
+	}
+}
+
+const char* IndexedFrameBuffer::expandKernel() const noexcept {
+#ifdef HAS_SSSE3_EXPAND
+	if (_paletteSize <= 16) { return "ssse3 pshufb"; }
+#endif
+#ifdef HAS_AVX2_EXPAND
+	return "avx2 gather";
+#else
+	return "scalar";
+#endif
+}
+
+const Uint32* IndexedFrameBuffer::expandToRGBA() noexcept {
+	_expanded.resize(_pixels.size()); //only allocates on first use
+	expand(_expanded.data(), _width * static_cast<int>(sizeof(Uint32)));
+	return _expanded.data();
+}
+
+void IndexedFrameBuffer::setUpscale(const SDL_Rect& src, const SDL_Rect& dst) noexcept {
+	_scaledSrc = src;
+	_scaledDst = dst;
+}
+
+void IndexedFrameBuffer::present(const Renderer& r) noexcept {
+	SDL_assert(_texture && "IndexedFrameBuffer: can't present without a renderer. Pass one to the constructor.");
+	void* pixels = nullptr;
+	int pitch = 0;
+	if (SDL_LockTexture(_texture.get(), nullptr, &pixels, &pitch) != 0) {
+		SDL_assert(false && "IndexedFrameBuffer: failed to lock texture.");
+		return;
+	}
+	expand(static_cast<Uint32*>(pixels), pitch);
+	SDL_UnlockTexture(_texture.get());
+	r.copy(_texture.get());
+	if (_scaledSrc.w != _scaledDst.w || _scaledSrc.h != _scaledDst.h) {
+		r.copy(_texture.get(), &_scaledSrc, &_scaledDst); //let the GPU do the upscaling
+	}
+	r.present();
+}
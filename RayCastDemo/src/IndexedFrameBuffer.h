@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "SDLex.h"
+class Renderer;
+struct SDL_Color;
+struct SDL_Rect;
+
+// An 8-bit framebuffer: all drawing writes palette indices (1 byte per pixel instead of 4).
+// The indices are expanded to 32-bit colors once per frame, in present(). Since the palette is only applied there,
+// palette cycling animates the whole frame without redrawing anything.
+class IndexedFrameBuffer {
+public:
+	static constexpr int MAX_COLORS = 256;
+	using PaletteIndex = uint8_t;
+
+private:
+	int _width = 0;
+	int _height = 0;
+	std::vector<PaletteIndex> _pixels; //allocated once, at construction
+	std::vector<Uint32> _expanded; //staging buffer for headless use, when there is no texture to expand into
+	std::array<Uint32, MAX_COLORS> _palette{}; //palette index -> ARGB8888
+	int _paletteSize = 0;
+	PaletteIndex _color = 0;
+	SDLex::TexturePtr _texture; //null when running headless
+	SDL_Rect _scaledSrc{}; //a region rendered at a lower resolution...
+	SDL_Rect _scaledDst{}; //...and where to stretch it to, on present
+	IndexedFrameBuffer(const IndexedFrameBuffer&) = delete; //disable copy constructor
+	IndexedFrameBuffer& operator=(IndexedFrameBuffer&) = delete; //disable copy assignment
+
+	bool isInside(int x, int y) const noexcept {
+		return (x >= 0 && x < _width && y >= 0 && y < _height);
+	}
+	void expand(Uint32* dst, int pitch) const noexcept;
+
+public:
+	IndexedFrameBuffer(int width, int height, const Renderer* r = nullptr); //pass a renderer to be able to present()
+	void setPalette(std::span<const SDL_Color> colors) noexcept;
+	void setPaletteEntry(int index, const SDL_Color& c) noexcept;
+	void cyclePalette(int first, int count, int step = 1) noexcept; //rotate a range of entries, for palette animation
+	void setColor(PaletteIndex index) noexcept { _color = index; }
+	void clear(PaletteIndex index) noexcept;
+	void setPixel(int x, int y) noexcept;
+	void drawLine(int x1, int y1, int x2, int y2) noexcept;
+	void drawVerticalLine(int x, int y1, int y2) noexcept;
+	void drawRect(const SDL_Rect& rect) noexcept;
+	void drawFilledRect(const SDL_Rect& rect) noexcept;
+	void scrollRegion(const SDL_Rect& rect, int dx) noexcept; //move the pixels inside rect sideways. Uncovered columns keep their old contents.
+	void setUpscale(const SDL_Rect& src, const SDL_Rect& dst) noexcept; //stretch src to dst on present. Eg. for dynamic resolution.
+	void present(const Renderer& r) noexcept; //expand to RGBA, upload and present
+	const Uint32* expandToRGBA() noexcept; //headless: expand into an internal buffer and return it
+	const char* expandKernel() const noexcept; //which expansion loop present() runs with the current palette, as compiled
+
+	int width() const noexcept { return _width; }
+	int height() const noexcept { return _height; }
+	const PaletteIndex* data() const noexcept { return _pixels.data(); }
+	PaletteIndex* data() noexcept { return _pixels.data(); }
+};
@@ -14,6 +14,7 @@ InputManager::~InputManager() {
 }
 void InputManager::update() noexcept {
 	_mouse.reset();
+	_inputEventTime = 0;
 	SDL_Event e;
 	while (SDL_PollEvent(&e)) {
 		switch (e.type) {		
@@ -24,15 +25,19 @@ void InputManager::update() noexcept {
 			onMouseWheel(e.wheel);
 			break;
 		case SDL_MOUSEBUTTONUP:
+			onInputEvent(e.button.timestamp);
 			onMouseButtonUp(e.button);
 			break;
 		case SDL_MOUSEBUTTONDOWN:
+			onInputEvent(e.button.timestamp);
 			onMouseButtonDown(e.button);
 			break;
 		case SDL_KEYUP:
+			onKeyEvent(e.key);
 			//onKeyUp(e.key);
 			break;
 		case SDL_KEYDOWN:
+			onKeyEvent(e.key);
 			//onKeyDown(e.key);
 			break;
 		case SDL_QUIT:
@@ -46,6 +51,18 @@ void InputManager::update() noexcept {
 		}	
 	}
 }
+void InputManager::latch() noexcept {
+	SDL_PumpEvents(); //updates the key states _keyStates points at, and queues the events behind them
+	_inputEventTime = 0;
+	std::array<SDL_Event, 32> events; //the front of the queue: more key events than a frame ever sees
+	const int count = SDL_PeepEvents(events.data(), static_cast<int>(events.size()), SDL_PEEKEVENT, SDL_KEYDOWN, SDL_KEYUP);
+	for (int i = _latchedKeyEvents; i < count; i++) { //skip the ones an earlier latch() reported
+		if (events[i].type == SDL_KEYUP || !events[i].key.repeat) {
+			onInputEvent(events[i].key.timestamp);
+		}
+	}
+	_latchedKeyEvents = std::max(count, _latchedKeyEvents);
+}
 void InputManager::setRelativeMouseMode(bool on) const noexcept {
 	int res = SDL_SetRelativeMouseMode(SDLex::fromBool(on));
 	SDL_assert(res == 0);
@@ -70,6 +87,9 @@ int InputManager::scrollX() const noexcept{
 int InputManager::scrollY() const noexcept{
 	return _mouse.scrollX;
 }
+Uint64 InputManager::inputEventTime() const noexcept {
+	return _inputEventTime;
+}
 bool InputManager::quitRequested() const noexcept {
 	return _wantExit || isKeyDown(SDL_SCANCODE_ESCAPE);
 }
@@ -90,6 +110,21 @@ void InputManager::onWindowEvent(const SDL_WindowEvent& e) noexcept {
 	}		
 	//broadCastEvent<WindowEvent>(e, this);
 }
+void InputManager::onInputEvent(Uint32 timestamp) noexcept {
+	if (_inputEventTime != 0) { return; } //keep the oldest
+	//event timestamps are SDL_GetTicks() milliseconds. Convert to the performance counter by subtracting the event's age.
+	const Uint32 age_ms = SDL_GetTicks() - timestamp;
+	_inputEventTime = SDL_GetPerformanceCounter() - (static_cast<Uint64>(age_ms) * SDL_GetPerformanceFrequency()) / 1000;
+}
+void InputManager::onKeyEvent(const SDL_KeyboardEvent& e) noexcept {
+	if (_latchedKeyEvents > 0) { //latch() has reported it already
+		_latchedKeyEvents--;
+		return;
+	}
+	if (e.type == SDL_KEYUP || !e.repeat) {
+		onInputEvent(e.timestamp);
+	}
+}
 void InputManager::onMouseWheel(const SDL_MouseWheelEvent& e) noexcept {
 	_mouse.scrollX = e.x; 
 	_mouse.scrollY = e.y;
@@ -33,11 +33,18 @@ class InputManager {
 	std::array<bool, 6> _buttonStates{};
 	bool _wantExit = false;
 	bool _wantPause = false;				
+	Uint64 _inputEventTime = 0; //oldest key or button event in the last update(), as a Timer::now() time
+	int _latchedKeyEvents = 0; //key events at the front of the queue that latch() already reported
+	void onInputEvent(Uint32 timestamp) noexcept;
+	void onKeyEvent(const SDL_KeyboardEvent& e) noexcept;
 
 public:
 	InputManager();
 	~InputManager();
 	void update() noexcept;
+	// Late latching: refresh the held keys without taking events off the queue, so update() stays once per frame.
+	// inputEventTime() becomes the oldest key event that is new since; the next update() won't report those again.
+	void latch() noexcept;
 	bool isKeyDown(const SDL_Scancode& key) const noexcept;
 	bool isButtonDown(MouseButton b) const noexcept;
 	bool quitRequested() const noexcept;
@@ -47,6 +54,7 @@ public:
 	int mouseY() const noexcept;
 	int scrollX() const noexcept;
 	int scrollY() const noexcept;
+	Uint64 inputEventTime() const noexcept; //when the oldest key / button event handled by the last update() happened. 0 if there was none.
 
 	//TODO: with C++20 this should take a std::span and not be templated... 
 	template<typename Container>
@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Profiler.h"
+// A fixed set of worker threads for data-parallel loops. parallelFor() splits [0, count) into chunks of grain items,
+// hands them out through one atomic counter, works on them on the calling thread too, and returns when all are done.
+// The loop body is passed by pointer, never copied into a std::function, so a call allocates nothing.
+// One loop at a time: call parallelFor() from one thread only.
+class JobPool {
+	using Body = void (*)(const void* fn, size_t begin, size_t end);
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _wake; //workers wait here for the next loop
+	std::condition_variable _done; //parallelFor() waits here for the workers to finish it
+	uint64_t _generation = 0; //bumped for every loop, so a worker never runs the same one twice
+	int _busy = 0; //workers that haven't finished the current loop
+	bool _stopping = false;
+	//the current loop
+	Body _body = nullptr;
+	const void* _fn = nullptr;
+	size_t _count = 0;
+	size_t _grain = 1;
+	std::atomic<size_t> _next{ 0 };
+	JobPool(const JobPool&) = delete; //disable copy constructor
+	JobPool& operator=(JobPool&) = delete; //disable copy assignment
+
+	void work() noexcept {
+		for (size_t begin = _next.fetch_add(_grain); begin < _count; begin = _next.fetch_add(_grain)) {
+			_body(_fn, begin, std::min(begin + _grain, _count));
+		}
+	}
+
+	void run() noexcept {
+		PROFILE_THREAD("jobs");
+		uint64_t seen = 0;
+		std::unique_lock lock(_mutex);
+		while (true) {
+			_wake.wait(lock, [&] { return _stopping || _generation != seen; });
+			if (_stopping) { return; }
+			seen = _generation;
+			lock.unlock();
+			work();
+			lock.lock();
+			if (--_busy == 0) { _done.notify_one(); }
+		}
+	}
+
+public:
+	//threads: workers besides the calling thread. Negative: one per remaining core.
+	explicit JobPool(int threads = -1) {
+		if (threads < 0) {
+			threads = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+		}
+		_workers.reserve(threads);
+		for (int i = 0; i < threads; i++) {
+			_workers.emplace_back(&JobPool::run, this);
+		}
+	}
+	~JobPool() {
+		{
+			std::lock_guard lock(_mutex);
+			_stopping = true;
+		}
+		_wake.notify_all();
+		for (auto& worker : _workers) {
+			worker.join();
+		}
+	}
+
+	//fn(begin, end) for every chunk of [0, count). Small loops run inline, without waking anyone.
+	template<typename Fn>
+	void parallelFor(size_t count, size_t grain, const Fn& fn) {
+		assert(grain > 0);
+		if (_workers.empty() || count <= grain) {
+			if (count > 0) { fn(size_t{ 0 }, count); }
+			return;
+		}
+		{
+			std::lock_guard lock(_mutex);
+			assert(_busy == 0 && "JobPool: parallelFor() is not reentrant");
+			_body = [](const void* f, size_t begin, size_t end) { (*static_cast<const Fn*>(f))(begin, end); };
+			_fn = &fn;
+			_count = count;
+			_grain = grain;
+			_next.store(0, std::memory_order_relaxed);
+			_busy = static_cast<int>(_workers.size());
+			_generation++;
+		}
+		_wake.notify_all();
+		work();
+		std::unique_lock lock(_mutex);
+		_done.wait(lock, [&] { return _busy == 0; }); //fn lives on our stack: nobody may still be using it
+	}
+
+	int threads() const noexcept { return static_cast<int>(_workers.size()) + 1; } //including the caller
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "Config.h"
+#include "Timer.h"
+// Input-to-photon latency. The timestamp of an input event (see InputManager::inputEventTime) travels with the Actions
+// into the simulation, which stamps the first Snapshot that applied it. When a frame built from that snapshot has been
+// presented, the difference is one sample. Only one input is in flight at a time: the oldest one not yet on screen.
+// Measures until present() returns. With vsync that is the flip, not the end of scan-out, so the display adds a bit more.
+class LatencyMeter {
+public:
+	static constexpr int BUCKET_MS = 1;
+	static constexpr int BUCKETS = 100; //the last bucket collects everything slower
+private:
+	std::array<uint32_t, BUCKETS> _histogram{};
+	uint32_t _samples = 0;
+	double _total_ms = 0.0;
+	double _max_ms = 0.0;
+	Uint64 _pending = 0; //event time of the input we are waiting to see presented
+
+public:
+	void onInput(Uint64 eventTime) noexcept { //after InputManager::update
+		if (eventTime != 0 && _pending == 0) {
+			_pending = eventTime;
+		}
+	}
+	Uint64 pending() const noexcept { //hand this to the simulation along with the Actions
+		return _pending;
+	}
+	void onPresent(Uint64 appliedInputTime) noexcept { //after present, with the input time of the snapshot that was drawn
+		if (_pending == 0 || appliedInputTime != _pending) { return; }
+		const double ms = Timer::millisecondsSince(_pending);
+		_histogram[std::min(static_cast<int>(ms) / BUCKET_MS, BUCKETS - 1)]++;
+		_samples++;
+		_total_ms += ms;
+		_max_ms = std::max(_max_ms, ms);
+		_pending = 0;
+	}
+	uint32_t samples() const noexcept {
+		return _samples;
+	}
+	double percentile(double p) const noexcept { //upper edge of the bucket holding the p'th sample
+		const auto target = static_cast<uint32_t>(p * _samples);
+		uint32_t seen = 0;
+		for (int i = 0; i < BUCKETS; i++) {
+			seen += _histogram[i];
+			if (seen > target) { return (i + 1.0) * BUCKET_MS; }
+		}
+		return _max_ms;
+	}
+	void print(std::ostream& out) const {
+		if (_samples == 0) {
+			out << "input latency: no samples yet\n";
+			return;
+		}
+		out << std::fixed << std::setprecision(1) << "input latency over " << _samples << " inputs: mean " << _total_ms / _samples
+			<< " ms, p50 <" << percentile(0.5) << " ms, p90 <" << percentile(0.9) << " ms, p99 <" << percentile(0.99) << " ms, max " << _max_ms << " ms\n";
+		for (int i = 0; i < BUCKETS; i++) {
+			if (_histogram[i] == 0) { continue; }
+			out << std::setw(3) << i * BUCKET_MS << ((i == BUCKETS - 1) ? "+ ms " : "  ms ") << std::string(std::max(1u, (_histogram[i] * 50) / _samples), '#')
+				<< " " << _histogram[i] << "\n";
+		}
+		out.unsetf(std::ios::floatfield);
+	}
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <bitset>
 #include <cassert>
 static constexpr auto WORLD_ROWS = 16;
 static constexpr auto WORLD_COLUMNS = WORLD_ROWS;
@@ -6,62 +7,89 @@ static constexpr auto WORLD_SIZE = (WORLD_ROWS * Cfg::CELL_SIZE); //width and he
 static constexpr auto FIRST_VALID_CELL = 1; //to shortcut collision testing we can check against the map boundary walls. Helps with mouse interaction and for Q&D respawn when stuck in a wall.
 static constexpr auto LAST_VALID_CELL = WORLD_ROWS-2; //0 == wall, 15 == wall. so if our position is below or above the valid spaces, we can bail without performing lookup.
 
-#ifdef USE_BITMAP_LEVELDATA
-// use bitmap data to save memory, char array (bellow) for easier editing.
-//convert char array to bitmap using this: https://pastebin.com/fweGUGJE
-static constexpr uint_fast16_t  WORLD[WORLD_ROWS] = {
-    /*[ 0] 1111111111111111*/       0xffff,
-    /*[ 1] 1000000000000001*/       0x8001,
-    /*[ 2] 1001111100000001*/       0x9f01,
-    /*[ 3] 1001000101010101*/       0x9155,
-    /*[ 4] 1001000100000001*/       0x9101,
-    /*[ 5] 1001001100000001*/       0x9301,
-    /*[ 6] 1000000000000001*/       0x8001,
-    /*[ 7] 1000000000000001*/       0x8001,
-    /*[ 8] 1000000000000001*/       0x8001,
-    /*[ 9] 1001100111111001*/       0x99f9,
-    /*[10] 1001000000001001*/       0x9009,
-    /*[11] 1001110000001001*/       0x9c09,
-    /*[12] 1001000000001001*/       0x9009,
-    /*[13] 1001111111101001*/       0x9fe9,
-    /*[14] 1000000000000001*/       0x8001,
-    /*[15] 1111111111111111*/       0xffff,
-};
-inline constexpr bool isWall(int x, int y) noexcept {
-    if (x < FIRST_VALID_CELL || y < FIRST_VALID_CELL
-        || x > LAST_VALID_CELL || y > LAST_VALID_CELL) {
-        return true;
+// Both representations are always compiled, so the benchmark can race them against each other.
+// USE_BITMAP_LEVELDATA picks the one the game uses, as WORLD and isWall().
+namespace LevelBitmap {
+    // use bitmap data to save memory, char array (bellow) for easier editing.
+    //convert char array to bitmap using this: https://pastebin.com/fweGUGJE
+    static constexpr uint_fast16_t  WORLD[WORLD_ROWS] = {
+        /*[ 0] 1111111111111111*/       0xffff,
+        /*[ 1] 1000000000000001*/       0x8001,
+        /*[ 2] 1001111100000001*/       0x9f01,
+        /*[ 3] 1001000101010101*/       0x9155,
+        /*[ 4] 1001000100000001*/       0x9101,
+        /*[ 5] 1001001100000001*/       0x9301,
+        /*[ 6] 1000000000000001*/       0x8001,
+        /*[ 7] 1000000000000001*/       0x8001,
+        /*[ 8] 1000000000000001*/       0x8001,
+        /*[ 9] 1001100111111001*/       0x99f9,
+        /*[10] 1001000000001001*/       0x9009,
+        /*[11] 1001110000001001*/       0x9c09,
+        /*[12] 1001000000001001*/       0x9009,
+        /*[13] 1001111111101001*/       0x9fe9,
+        /*[14] 1000000000000001*/       0x8001,
+        /*[15] 1111111111111111*/       0xffff,
+    };
+    inline constexpr bool isWall(int x, int y) noexcept {
+        if (x < FIRST_VALID_CELL || y < FIRST_VALID_CELL
+            || x > LAST_VALID_CELL || y > LAST_VALID_CELL) {
+            return true;
+        }
+        return (WORLD[y] >> ((WORLD_COLUMNS - 1) - x) & 0x01);
     }
-    return (WORLD[y] >> ((WORLD_COLUMNS - 1) - x) & 0x01);
 }
-#else //use the char array representation for quicker editing and testing. It is probably also faster due to the simpler lookup?
-static constexpr char WORLD[WORLD_ROWS][WORLD_COLUMNS] = { // world map
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,1,1,1,1,1,0,0,0,0,0,0,0,1},
-    {1,0,0,1,0,0,0,1,0,1,0,1,0,1,0,1},
-    {1,0,0,1,0,0,0,1,0,0,0,0,0,0,0,1},
-    {1,0,0,1,0,0,1,1,0,0,0,0,0,0,0,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1},
-    {1,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1},
-    {1,0,0,1,1,1,0,0,0,0,0,0,1,0,0,1},
-    {1,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1},
-    {1,0,0,1,1,1,1,1,1,1,1,0,1,0,0,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
-};
-inline constexpr bool isWall(int x, int y) noexcept {
-    if (x < FIRST_VALID_CELL || y < FIRST_VALID_CELL
-        || x > LAST_VALID_CELL || y > LAST_VALID_CELL) {
-        return true;
+
+namespace LevelChars { //the char array representation, for quicker editing and testing. It is probably also faster due to the simpler lookup?
+    static constexpr char WORLD[WORLD_ROWS][WORLD_COLUMNS] = { // world map
+        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+        {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+        {1,0,0,1,1,1,1,1,0,0,0,0,0,0,0,1},
+        {1,0,0,1,0,0,0,1,0,1,0,1,0,1,0,1},
+        {1,0,0,1,0,0,0,1,0,0,0,0,0,0,0,1},
+        {1,0,0,1,0,0,1,1,0,0,0,0,0,0,0,1},
+        {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+        {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+        {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+        {1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1},
+        {1,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1},
+        {1,0,0,1,1,1,0,0,0,0,0,0,1,0,0,1},
+        {1,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1},
+        {1,0,0,1,1,1,1,1,1,1,1,0,1,0,0,1},
+        {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
+    };
+    inline constexpr bool isWall(int x, int y) noexcept {
+        if (x < FIRST_VALID_CELL || y < FIRST_VALID_CELL
+            || x > LAST_VALID_CELL || y > LAST_VALID_CELL) {
+            return true;
+        }
+        return (WORLD[y][x] != 0);
     }
-    return (WORLD[y][x] != 0);
 }
+
+#ifdef USE_BITMAP_LEVELDATA
+using LevelBitmap::WORLD;
+using LevelBitmap::isWall;
+#else
+using LevelChars::WORLD;
+using LevelChars::isWall;
 #endif //USE_BITMAP_LEVELDATA
 
+constexpr bool levelRepresentationsAgree() noexcept {
+    for (int y = -1; y <= WORLD_ROWS; y++) { //include a ring of out-of-bounds cells
+        for (int x = -1; x <= WORLD_COLUMNS; x++) {
+            if (LevelBitmap::isWall(x, y) != LevelChars::isWall(x, y)) { return false; }
+        }
+    }
+    return true;
+}
+static_assert(levelRepresentationsAgree() && "Bad map data: LevelBitmap and LevelChars describe different maps. Edit both.");
+
+using CellSet = std::bitset<WORLD_ROWS * WORLD_COLUMNS>; //one bit per cell of the level, eg. the cells visible this frame
+constexpr int cellIndex(int x, int y) noexcept {
+    return y * WORLD_COLUMNS + x;
+}
+
 static_assert(WORLD_ROWS == WORLD_COLUMNS && "Bad map data: The map must be square - WORLD_ROWS == WORLD_COLUMNS");
 static_assert(Utils::isPowerOfTwo(WORLD_SIZE) && "Bad map data: World width and height must be a power-of-2");
 static_assert(!isWall(FIRST_VALID_CELL, FIRST_VALID_CELL) && "Bad map data: FIRST_VALID_CELL must be an empty space.");
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+// Generated by 'RayCastBench pvs --samples 8'. Don't edit, regenerate after changing the map in LevelData.h.
+// 156 open cells, 4987 visible pairs. Unpack with PVS::decompress(), see PVS.h.
+namespace LevelPVS {
+    static constexpr uint32_t LEVEL_HASH = 0xc179c941;
+    static constexpr uint8_t DATA[1512] = {
+        0xff, 0xff, 0xff, 0xc0, 0x01, 0x18, 0xc0, 0x01, 0x70, 0x00, 0x3c, 0x00, 0xc3, 0x00, 0x0c, 0x30,
+        0x00, 0xe3, 0x00, 0xf8, 0xff, 0xff, 0x03, 0x07, 0x60, 0x00, 0x07, 0xc0, 0x01, 0x70, 0x00, 0x0c,
+        0x03, 0x30, 0xc0, 0x00, 0x8c, 0x03, 0xe0, 0xff, 0xff, 0x07, 0x0f, 0xc0, 0x00, 0x06, 0x80, 0x01,
+        0x60, 0x00, 0x18, 0x06, 0x60, 0x80, 0x01, 0x18, 0x03, 0xc0, 0xff, 0xff, 0x03, 0x03, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0xff, 0xff, 0xc0,
+        0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0,
+        0xff, 0x3f, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0xf8, 0xff, 0x07, 0x0f, 0x06, 0x30, 0x00, 0x1c, 0x00, 0x07, 0xc0, 0x03, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x7f, 0xf0, 0xe0, 0x01, 0x1b, 0xe0, 0x0f, 0x78, 0x07, 0xfe,
+        0x61, 0x00, 0x06, 0x10, 0x00, 0x01, 0x00, 0xf0, 0xff, 0x83, 0x07, 0x0d, 0xe8, 0x00, 0x7b, 0xc0,
+        0x3e, 0xb0, 0x0f, 0x03, 0x30, 0xc0, 0x00, 0x08, 0x01, 0x80, 0xff, 0x0f, 0x1e, 0xfc, 0xc0, 0x0d,
+        0xf8, 0x03, 0xbe, 0xc0, 0x3f, 0x04, 0xc0, 0x00, 0x03, 0x20, 0x04, 0x00, 0xfe, 0x1f, 0x3c, 0xb0,
+        0xc1, 0x1d, 0x78, 0x07, 0xdf, 0xe1, 0x77, 0x9e, 0x83, 0x01, 0x06, 0x60, 0x0c, 0x00, 0xff, 0x1f,
+        0x3c, 0xf0, 0xc3, 0x0e, 0xf8, 0x07, 0xf7, 0xe1, 0x7f, 0x9e, 0x83, 0x01, 0x06, 0x60, 0x0c, 0x00,
+        0xff, 0x0f, 0x1e, 0x60, 0x81, 0x0b, 0xf0, 0x02, 0xbe, 0xc0, 0x2f, 0x08, 0x80, 0x00, 0x02, 0x20,
+        0x04, 0x00, 0xff, 0x83, 0x07, 0x78, 0x60, 0x03, 0xfc, 0x80, 0x3b, 0xf0, 0x0f, 0x03, 0x30, 0xc0,
+        0x00, 0x8c, 0x01, 0xf0, 0x80, 0x01, 0x03, 0x30, 0x80, 0x03, 0xe0, 0x01, 0x78, 0x00, 0x86, 0x01,
+        0x18, 0x60, 0x00, 0xc6, 0x01, 0x00, 0x18, 0x30, 0x00, 0x03, 0x38, 0x00, 0x0e, 0x80, 0x03, 0x60,
+        0x18, 0x80, 0x01, 0x06, 0x60, 0x1c, 0x00, 0x3f, 0x78, 0x30, 0x80, 0x03, 0xf0, 0x01, 0xfc, 0x00,
+        0x7f, 0x30, 0x00, 0x03, 0x08, 0x00, 0x00, 0x00, 0xf8, 0xe0, 0x41, 0x03, 0x3a, 0xc0, 0x1e, 0xb0,
+        0x0f, 0xec, 0xc3, 0x00, 0x0c, 0x30, 0x00, 0x42, 0x00, 0xe0, 0xc1, 0x03, 0x07, 0x7c, 0x80, 0x3f,
+        0xf0, 0x1f, 0xfe, 0xe7, 0x39, 0x18, 0x60, 0x00, 0x84, 0x00, 0xc0, 0xc1, 0x03, 0x1b, 0xdc, 0x81,
+        0x77, 0xf0, 0x1d, 0x7e, 0xe7, 0x39, 0x18, 0x60, 0x00, 0xc6, 0x00, 0xf0, 0xe0, 0x01, 0x0e, 0xf8,
+        0x00, 0x3f, 0xe0, 0x0f, 0xfc, 0xc3, 0x00, 0x0c, 0x30, 0x00, 0x63, 0x00, 0x38, 0x78, 0x80, 0x05,
+        0x2e, 0xc0, 0x0b, 0xf8, 0x02, 0xbf, 0x20, 0x00, 0x02, 0x08, 0x80, 0x10, 0x00, 0x04, 0x0f, 0xc0,
+        0x00, 0x07, 0xe0, 0x01, 0x7c, 0x80, 0x1f, 0x06, 0x60, 0x80, 0x01, 0x18, 0x03, 0xe0, 0x01, 0x03,
+        0x30, 0x80, 0x03, 0xe0, 0x01, 0xf8, 0x00, 0x9e, 0x1d, 0xf8, 0x60, 0x1c, 0xc6, 0x01, 0x00, 0x18,
+        0x80, 0x01, 0x1c, 0x00, 0x07, 0xc0, 0x03, 0x30, 0x0c, 0xc0, 0x00, 0x03, 0x30, 0x0e, 0x80, 0x81,
+        0x03, 0x18, 0xc0, 0x03, 0xf0, 0x01, 0xfe, 0x80, 0xb3, 0x03, 0x0f, 0xc4, 0x41, 0x08, 0x00, 0x02,
+        0x07, 0x30, 0x80, 0x07, 0xf0, 0x01, 0xfe, 0x80, 0xe7, 0x07, 0x1e, 0x88, 0x81, 0x10, 0x00, 0x00,
+        0x07, 0x30, 0xc0, 0x03, 0xf8, 0x00, 0x3e, 0x80, 0xe3, 0x01, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00,
+        0xfc, 0xe1, 0x0f, 0xfc, 0x03, 0xff, 0xe0, 0x3f, 0x8e, 0xc1, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00,
+        0x7f, 0xf8, 0x83, 0xff, 0xf0, 0x3f, 0xff, 0xcf, 0x73, 0x30, 0xc0, 0x00, 0x08, 0x01, 0x00, 0xe0,
+        0x0f, 0x7f, 0xf8, 0x9f, 0xff, 0xff, 0xff, 0xff, 0x06, 0x06, 0x18, 0x80, 0x31, 0x00, 0x0c, 0xfe,
+        0xf0, 0xc7, 0xff, 0xff, 0xff, 0xff, 0xff, 0x67, 0x60, 0x80, 0x01, 0x18, 0x03, 0xe0, 0x01, 0x18,
+        0xc0, 0x03, 0xf0, 0x03, 0xfc, 0x03, 0xcf, 0x1e, 0xfc, 0x30, 0x1e, 0xe3, 0x00, 0x00, 0x60, 0x00,
+        0x07, 0xc0, 0x03, 0xf0, 0x01, 0x3c, 0x3b, 0xf0, 0xc1, 0x38, 0x8c, 0x03, 0x60, 0x00, 0x03, 0xf8,
+        0x00, 0xff, 0xe0, 0xff, 0x78, 0x76, 0xe0, 0x83, 0x38, 0x08, 0x01, 0x40, 0x00, 0x03, 0x7c, 0x80,
+        0x3f, 0xe0, 0x1f, 0x78, 0x7e, 0xe0, 0x81, 0x38, 0x08, 0x00, 0x00, 0x80, 0x01, 0x1e, 0xc0, 0x07,
+        0xf0, 0x01, 0x1c, 0x0f, 0x10, 0x40, 0x00, 0x00, 0x00, 0xe0, 0x87, 0x3f, 0xf0, 0x0f, 0xfe, 0xc3,
+        0xff, 0x3c, 0x07, 0x13, 0x08, 0x00, 0x00, 0x00, 0xf8, 0xf0, 0x07, 0xff, 0xf1, 0x7f, 0xff, 0xff,
+        0xef, 0x60, 0x02, 0x01, 0x10, 0x00, 0x00, 0x0f, 0x7f, 0xf8, 0xdf, 0xff, 0xff, 0xff, 0xff, 0x0e,
+        0x06, 0x18, 0x00, 0x21, 0x00, 0x70, 0xf8, 0xe3, 0xff, 0xff, 0xff, 0xff, 0xff, 0x77, 0x30, 0xc0,
+        0x00, 0x8c, 0x01, 0xc0, 0xe1, 0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xdf, 0xc0, 0x00, 0x03, 0x30,
+        0x06, 0x80, 0xc3, 0xdf, 0xff, 0xff, 0xff, 0xff, 0xff, 0x9f, 0x81, 0x01, 0x06, 0x60, 0x0c, 0x80,
+        0xc3, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x9f, 0x81, 0x01, 0x06, 0x60, 0x0c, 0x80, 0x07, 0xf0,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xbf, 0x07, 0x3f, 0x8c, 0xcf, 0x39, 0x00, 0x00, 0xfc, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xef, 0xc1, 0x0f, 0xe3, 0x31, 0x0e, 0x80, 0x80, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0x1d, 0xf8, 0x20, 0x1e, 0x42, 0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x81,
+        0x06, 0xe2, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f, 0x07, 0x12, 0x00, 0x00,
+        0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x1d, 0x0c, 0x20, 0x00, 0x00, 0x00, 0xe0,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3b, 0x18, 0x40, 0x00, 0x04, 0x00, 0xc0, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0x19, 0x18, 0x60, 0x00, 0x86, 0x00, 0xe0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0x0c, 0x0c, 0x30, 0x00, 0x63, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3f, 0x03, 0x03, 0x0c,
+        0xc0, 0x18, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x67, 0x60, 0x80, 0x01, 0x18, 0x03, 0xe0,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x39, 0xd8, 0x63, 0x78, 0xce, 0x01, 0xf0, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xef, 0xc1, 0x1f, 0xe3, 0x73, 0x0e, 0x80, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbf, 0x07,
+        0x3f, 0xcc, 0xc7, 0x18, 0x00, 0xfe, 0xff, 0xff, 0xff, 0xff, 0x7f, 0x07, 0x3e, 0x88, 0x87, 0x10,
+        0x00, 0xfc, 0xff, 0xff, 0xff, 0xff, 0xff, 0x07, 0x3a, 0x80, 0x03, 0x00, 0x00, 0xfc, 0xff, 0xff,
+        0xff, 0xff, 0xdf, 0x03, 0x0c, 0xe0, 0x00, 0x00, 0x00, 0xfe, 0xff, 0xff, 0xff, 0xff, 0x77, 0x20,
+        0x01, 0x18, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0e, 0x24, 0x00, 0x00, 0x00, 0x00,
+        0xf0, 0xff, 0xff, 0xff, 0xff, 0xe7, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+        0x3f, 0x03, 0x03, 0x08, 0x00, 0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0x0c, 0x0c, 0x30, 0x00,
+        0x42, 0x00, 0xf0, 0xff, 0xff, 0xff, 0xff, 0x19, 0x18, 0x60, 0x00, 0xc6, 0x00, 0xf0, 0xff, 0xff,
+        0xff, 0xff, 0x01, 0x18, 0x60, 0x00, 0xc6, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0x00, 0x0c, 0x30,
+        0x00, 0x63, 0x00, 0xfc, 0xff, 0xff, 0xff, 0xff, 0x1c, 0xcc, 0x31, 0x38, 0xe7, 0x00, 0xf8, 0xff,
+        0xff, 0xff, 0x9f, 0x83, 0x3d, 0x86, 0xe7, 0x1c, 0x00, 0xff, 0xff, 0xff, 0xff, 0x3d, 0xf8, 0x63,
+        0x7e, 0xce, 0x00, 0xf0, 0xff, 0xff, 0xff, 0xef, 0x41, 0x0f, 0xf1, 0x43, 0x00, 0x80, 0xff, 0xff,
+        0xff, 0xdf, 0x03, 0x1c, 0xc0, 0x03, 0x00, 0x00, 0xfe, 0xff, 0xff, 0xbf, 0x07, 0x18, 0xc0, 0x03,
+        0x00, 0x00, 0xfc, 0xff, 0xff, 0x9f, 0x03, 0x08, 0xc0, 0x00, 0x00, 0x00, 0xfc, 0xff, 0xff, 0xcf,
+        0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xff, 0xff, 0x33, 0x20, 0x00, 0x00, 0x00, 0x00, 0x80,
+        0xff, 0xff, 0x7f, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xff, 0xff, 0x07, 0x60, 0x00, 0x01,
+        0x10, 0x00, 0x00, 0xff, 0xff, 0x3f, 0x00, 0x03, 0x0c, 0xc0, 0x18, 0x00, 0xfe, 0xff, 0xff, 0x00,
+        0x0c, 0x30, 0x00, 0x63, 0x00, 0xfc, 0xff, 0xff, 0x01, 0x18, 0x60, 0x00, 0xc6, 0x00, 0xf8, 0xff,
+        0xff, 0x07, 0x60, 0x80, 0x01, 0x18, 0x07, 0xc0, 0xff, 0xff, 0x03, 0x30, 0xc0, 0x00, 0x8c, 0x03,
+        0xe0, 0xff, 0xff, 0x1c, 0xec, 0x31, 0x3c, 0x67, 0x00, 0xf8, 0xff, 0xcf, 0x03, 0x3e, 0xe0, 0x87,
+        0x00, 0x00, 0xff, 0x7f, 0x3e, 0xe0, 0x03, 0x7e, 0x08, 0x00, 0xf0, 0xff, 0xf3, 0x00, 0x07, 0xf8,
+        0x00, 0x00, 0x80, 0xff, 0xcf, 0x01, 0x04, 0x60, 0x00, 0x00, 0x00, 0xfe, 0x9f, 0x01, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0xfc, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0x0f, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0xfe, 0x03, 0x20, 0x00, 0x00, 0x00, 0x00, 0x80, 0x7f, 0x00, 0x06, 0x18, 0x80,
+        0x31, 0x00, 0xfc, 0x07, 0x60, 0x80, 0x01, 0x18, 0x03, 0xe0, 0x3f, 0x00, 0x03, 0x0c, 0xc0, 0x18,
+        0x00, 0x0f, 0x03, 0x30, 0xc0, 0x00, 0x8c, 0x03, 0x00, 0x06, 0x60, 0x80, 0x01, 0x18, 0x07, 0x40,
+        0xf8, 0x87, 0x1f, 0xf8, 0x21, 0x00, 0x00, 0xfc, 0xc3, 0x0f, 0xfe, 0x10, 0x00, 0x20, 0x00, 0x03,
+        0x0c, 0xc0, 0x18, 0x00, 0x07, 0x60, 0x80, 0x01, 0x18, 0x03, 0xe0, 0x01, 0x18, 0x60, 0x00, 0xc6,
+        0x01, 0x00, 0xc0, 0x00, 0x03, 0x30, 0x0e, 0x80, 0x3f, 0xfc, 0x80, 0x0f, 0x01, 0x00, 0x7e, 0xf8,
+        0x81, 0x1f, 0x02, 0x00, 0x7c, 0xf8, 0xc1, 0x1f, 0x02, 0x00, 0x3c, 0xfc, 0xf0, 0x0f, 0x01, 0x00,
+        0x0e, 0x3f, 0xfc, 0x43, 0x00, 0x98, 0xe1, 0x87, 0x7f, 0x08, 0x00, 0x13, 0x7e, 0xf8, 0x87, 0x00,
+        0x30, 0xf0, 0xc3, 0x3f, 0x04, 0xc0, 0x09, 0x30, 0x00, 0x63, 0x00, 0x1c, 0x60, 0x00, 0xc6, 0x00,
+        0x78, 0x80, 0x01, 0x18, 0x07, 0x00, 0xc0, 0x00, 0x8c, 0x03, 0xe0, 0xc3, 0x3f, 0x04, 0x00, 0x78,
+        0xf8, 0x87, 0x00, 0x00, 0x87, 0x7f, 0x08, 0x00, 0x30, 0xfc, 0x43, 0x00, 0x98, 0xf0, 0x0f, 0x01,
+        0x60, 0xe0, 0x1f, 0x02, 0xe0, 0x04, 0x60, 0x0c, 0x80, 0x03, 0x30, 0x06, 0xc0, 0x03, 0x30, 0x1e,
+        0x00, 0x00, 0xc6, 0x01, 0xf0, 0x87, 0x00, 0x00, 0x3f, 0x04, 0x00, 0xf8, 0x10, 0x00, 0xe0, 0x21,
+        0x00, 0xc0, 0x21, 0x00, 0xc0, 0x10, 0x00, 0x20, 0x04, 0x80, 0x81, 0x00, 0x38, 0x31, 0x00, 0x8e,
+        0x01, 0xf8, 0xf8, 0xff, 0xf1, 0xff, 0xf3, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x03,
+    };
+}
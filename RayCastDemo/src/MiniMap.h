@@ -1,13 +1,24 @@
 #pragma once
 #include "Config.h"
 #include "Graphics.h"
+#include "LevelData.h"
+#include "Profiler.h"
+#include "RayStats.h"
 
 namespace MiniMap {    
     static constexpr auto MAP_HEIGHT = WORLD_SIZE >> Cfg::MAP_SCALE_FACTOR; //target width and height of the minimap, in pixels. 
     static constexpr auto SCALED_CELL_SIZE = Cfg::CELL_SIZE >> Cfg::MAP_SCALE_FACTOR;
     static constexpr auto MAP_LEFT = VIEWPORT_RIGHT;
+    static constexpr auto FLOOR_COLOR = paletteIndexOf(White);
+    static constexpr auto WALL_COLOR = paletteIndexOf(DarkGreen);
+    //cold to hot, for the ray cost heatmap
+    static constexpr int HEAT_COLORS[]{
+        paletteIndexOf(DarkBlue), paletteIndexOf(LightBlue), paletteIndexOf(DarkMagenta), paletteIndexOf(DarkRed),
+        paletteIndexOf(LightRed), paletteIndexOf(Yellow), paletteIndexOf(White)
+    };
+    static constexpr int HEAT_COLOR_COUNT = sizeof(HEAT_COLORS) / sizeof(HEAT_COLORS[0]);
     
-    void drawLine(const Graphics& g, int x1, int y1, int x2, int y2, const SDL_Color& color) noexcept {  
+    void drawLine(const Graphics& g, int x1, int y1, int x2, int y2, int color) noexcept {  
         x1 = MAP_LEFT + (x1 >> Cfg::MAP_SCALE_FACTOR);
         y1 = (y1 >> Cfg::MAP_SCALE_FACTOR);
         x2 = MAP_LEFT + (x2 >> Cfg::MAP_SCALE_FACTOR);
@@ -15,24 +26,55 @@ namespace MiniMap {
         g.setColor(color);
         g.drawLine(x1, y1, x2, y2);
     }
-    void renderMap(const Graphics& g)  noexcept {
+    //fog of war: a wall shows once an open cell next to it has been seen
+    inline bool isRevealed(const CellSet& explored, int column, int row) noexcept {
+        if (!isWall(column, row)) { return explored[cellIndex(column, row)]; }
+        return (column > 0 && explored[cellIndex(column - 1, row)]) || (column < WORLD_COLUMNS - 1 && explored[cellIndex(column + 1, row)])
+            || (row > 0 && explored[cellIndex(column, row - 1)]) || (row < WORLD_ROWS - 1 && explored[cellIndex(column, row + 1)]);
+    }
+
+    //explored: only draw these cells (and the walls around them). Null draws the whole map.
+    void renderMap(const Graphics& g, const CellSet* explored = nullptr)  noexcept {
         if constexpr (false == Cfg::hasMinimap()) { return; }        
+        PROFILE_ZONE("MiniMap::renderMap");
         for (int row = 0; row < WORLD_ROWS; row++) {
             const auto top = (row * SCALED_CELL_SIZE);
             const auto bottom = top + SCALED_CELL_SIZE - 1;
             for (int column = 0; column < WORLD_COLUMNS; column++) {
+                if (explored && !isRevealed(*explored, column, row)) { continue; }
                 const auto left = MAP_LEFT + (column * SCALED_CELL_SIZE);
                 const auto right = left + SCALED_CELL_SIZE - 1;
                 const auto block = isWall(column, row);
                 if (!block) {
-                    g.setColor(White);
+                    g.setColor(FLOOR_COLOR);
                     g.drawRectangle(RectStyle::OUTLINE, left, top, right, bottom);
                 }
                 else {
-                    g.setColor(DarkGreen);
+                    g.setColor(WALL_COLOR);
                     g.drawRectangle(RectStyle::FILL, left, top, right, bottom);
                 }
             }
         }
     }
-}
\ No newline at end of file
+
+    //tint every cell by how often rays have visited it. Draw after renderMap, before the rays.
+    inline void renderHeatmap(const Graphics& g, const RayStats& stats) noexcept {
+        if constexpr (false == Cfg::hasMinimap()) { return; }
+        PROFILE_ZONE("MiniMap::renderHeatmap");
+        const auto max_visits = stats.maxCellVisits();
+        if (max_visits == 0) { return; }
+        for (int row = 0; row < WORLD_ROWS; row++) {
+            const auto top = (row * SCALED_CELL_SIZE) + 1;
+            const auto bottom = top + SCALED_CELL_SIZE - 2;
+            for (int column = 0; column < WORLD_COLUMNS; column++) {
+                const auto visits = stats.cellVisits[row * WORLD_COLUMNS + column];
+                if (visits == 0) { continue; }
+                const auto left = MAP_LEFT + (column * SCALED_CELL_SIZE) + 1;
+                const auto right = left + SCALED_CELL_SIZE - 2;
+                const auto heat = static_cast<int>((static_cast<uint64_t>(visits) * (HEAT_COLOR_COUNT - 1)) / max_visits);
+                g.setColor(HEAT_COLORS[heat]);
+                g.drawRectangle(RectStyle::FILL, left, top, right, bottom);
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include "Config.h"
+#include "GridTraversal.h"
+#include "LevelData.h"
+// Per-angle walking steps, so nothing that walks calls cos() or sin() per tick, and the wall collision shared by
+// everything that walks. ViewPoint moves one actor with these, EntityStore moves thousands.
+namespace Movement {
+	struct Step {
+		float dx = 0.0f, dy = 0.0f;
+	};
+
+	//one WALK_SPEED step along every table angle. Computed exactly like ViewPoint used to, so replays don't change.
+	//One entry past ANGLE_360, since turning left from ANGLE_0 lands the ViewPoint there.
+	inline const std::array<Step, ANGLE_360 + 1> WALK = [] {
+		std::array<Step, ANGLE_360 + 1> table{};
+		for (int angle = 0; angle <= ANGLE_360; angle++) {
+			table[angle] = { static_cast<float>(cos(angle * ANGLE_TO_RADIANS) * Cfg::WALK_SPEED), static_cast<float>(sin(angle * ANGLE_TO_RADIANS) * Cfg::WALK_SPEED) };
+		}
+		return table;
+	}();
+
+	// After a move of (dx, dy): if we stepped closer than OVERBOARD to a wall next to our cell, back up along that axis.
+	// Returns false when the position is inside a wall, which backing up can't fix.
+	template<typename IsWall>
+	constexpr bool pushOutOfWalls(int& x, int& y, float dx, float dy, const IsWall& isWall) noexcept {
+		const int x_cell = x / CELL_SIZE;
+		const int y_cell = y / CELL_SIZE;
+		if (isWall(x_cell, y_cell)) {
+			return false;
+		}
+		const int x_sub_cell = x % CELL_SIZE; // compute position within the cell
+		const int y_sub_cell = y % CELL_SIZE;
+		if (dx > 0 && isWall(x_cell + 1, y_cell)) {// moving right, towards a wall
+			if (x_sub_cell > (CELL_SIZE - OVERBOARD)) {
+				x -= (x_sub_cell - (CELL_SIZE - OVERBOARD)); // back up the amount we stepped over the line
+			}
+		}
+		else if (dx < 0 && isWall(x_cell - 1, y_cell)) {// moving left, towards a wall
+			if (x_sub_cell < (OVERBOARD)) {
+				x += (OVERBOARD - x_sub_cell);
+			}
+		}
+		if (dy > 0 && isWall(x_cell, y_cell + 1)) { // moving up
+			if (y_sub_cell > (CELL_SIZE - OVERBOARD)) {
+				y -= (y_sub_cell - (CELL_SIZE - OVERBOARD));
+			}
+		}
+		else if (dy < 0 && isWall(x_cell, y_cell - 1)) {// moving down
+			if (y_sub_cell < (OVERBOARD)) {
+				y += (OVERBOARD - y_sub_cell);
+			}
+		}
+		return true;
+	}
+
+	enum Blocked : int { BLOCKED_X = 1, BLOCKED_Y = 2 };
+
+	//move the leading edge of a square, at edge, by move along one axis: VERTICAL crosses x boundaries, like the
+	//GridTraversal walks. The edge steps across the cell boundaries ahead just as a ray does, and the move is cut short
+	//flush against the first one whose far side is blocked(cell). Returns whether it was.
+	template<bool VERTICAL, typename Blocked>
+	bool clipMove(int edge, int& move, const Blocked& blocked) noexcept {
+		GridTraversal::AxisWalk w;
+		for (int left = GridTraversal::initSegmentWalk(edge, 0, edge + move, 0, w); left > 0; left--, GridTraversal::advance(w)) {
+			if (blocked(VERTICAL ? GridTraversal::cellX<true>(w) : GridTraversal::cellY<false>(w))) {
+				move = w.boundary - edge - (move > 0 ? 1 : 0); //a forward edge is the last unit covered, one short of the boundary
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Move (x, y) by (mx, my) as a square reaching radius out from its center, and stop it flush against the first wall
+	// in its way. x first, then y from there, so a diagonal move into a wall slides along it. Only the columns (then
+	// rows) the leading edge enters are tested, walked with clipMove() like a ray stepping through the grid, so moves of
+	// any length resolve in one pass: nothing tunnels. Against the grid's axis-aligned walls a square is exact, except
+	// that it can't round a convex corner as closely as a circle would. Returns which axes were stopped.
+	template<typename IsWall>
+	int sweep(int& x, int& y, int mx, int my, int radius, const IsWall& isWall) noexcept {
+		int blocked = 0;
+		auto cellOf = [](int position) { return position >> CELL_SIZE_FP; };
+		const int top = cellOf(y - radius), bottom = cellOf(y + radius - 1);
+		auto columnBlocked = [&](int column) {
+			for (int row = top; row <= bottom; row++) {
+				if (isWall(column, row)) { return true; }
+			}
+			return false;
+		};
+		if (clipMove<true>(mx > 0 ? x + radius - 1 : x - radius, mx, columnBlocked)) {
+			blocked |= BLOCKED_X;
+		}
+		x += mx;
+		const int left = cellOf(x - radius), right = cellOf(x + radius - 1);
+		auto rowBlocked = [&](int row) {
+			for (int column = left; column <= right; column++) {
+				if (isWall(column, row)) { return true; }
+			}
+			return false;
+		};
+		if (clipMove<false>(my > 0 ? y + radius - 1 : y - radius, my, rowBlocked)) {
+			blocked |= BLOCKED_Y;
+		}
+		y += my;
+		return blocked;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include "Config.h"
+#include "LevelData.h"
+// A runtime, editable copy of the level's walls: one bitmask of open cells per row, bit x == column x.
+// Built from the same isWall() the renderer reads. Row bitmaps let searches expand a whole row of cells with a few shifts.
+class OccupancyGrid {
+public:
+	using Row = uint32_t;
+	static_assert(WORLD_COLUMNS <= 32, "OccupancyGrid: a row must fit in a Row");
+	static constexpr Row ALL_COLUMNS = (WORLD_COLUMNS == 32) ? ~Row{ 0 } : (Row{ 1 } << WORLD_COLUMNS) - 1;
+
+private:
+	std::array<Row, WORLD_ROWS> _open{};
+	uint32_t _version = 0; //bumped on every edit
+
+public:
+	template<auto IsWall>
+	static OccupancyGrid fromLevel() noexcept {
+		OccupancyGrid grid;
+		for (int y = 0; y < WORLD_ROWS; y++) {
+			for (int x = 0; x < WORLD_COLUMNS; x++) {
+				if (!IsWall(x, y)) { grid._open[y] |= Row{ 1 } << x; }
+			}
+		}
+		return grid;
+	}
+
+	static constexpr bool inBounds(int x, int y) noexcept {
+		return x >= 0 && x < WORLD_COLUMNS && y >= 0 && y < WORLD_ROWS;
+	}
+	bool isWall(int x, int y) const noexcept { //out of bounds is wall, like ::isWall()
+		return !inBounds(x, y) || !((_open[y] >> x) & 1);
+	}
+	//returns false if the cell already was what was asked for
+	bool setWall(int x, int y, bool wall) noexcept {
+		assert(inBounds(x, y) && "OccupancyGrid: cell out of bounds");
+		if (isWall(x, y) == wall) { return false; }
+		_open[y] ^= Row{ 1 } << x;
+		_version++;
+		return true;
+	}
+	Row openRow(int y) const noexcept {
+		return (y >= 0 && y < WORLD_ROWS) ? _open[y] : 0;
+	}
+	uint32_t version() const noexcept { return _version; }
+};
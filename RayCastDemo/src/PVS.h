@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "Config.h"
+#include "LevelData.h"
+#include "GridTraversal.h"
+// Potentially visible sets: for every open cell, which cells can be seen from anywhere inside it.
+// Built offline ("RayCastBench pvs") and stored next to the level data in LevelPVS.h. Good for culling entities and AI work,
+// not for rendering: it comes from sampled rays, so it is approximate. A pair seen only through a gap no sample ray hits
+// would be missing. "RayCastBench pvs" checks the build against random sight lines and refuses to write one that misses any.
+namespace PVS {
+    static constexpr int CELLS = WORLD_ROWS * WORLD_COLUMNS;
+    using Matrix = std::array<CellSet, CELLS>; //[from cell][to cell]
+
+    //FNV-1a over the map. Stored with the PVS, so we can tell when it was built for a different map.
+    constexpr uint32_t levelHash(const GridTraversal::WallRows& rows) noexcept {
+        uint32_t hash = 2166136261u;
+        for (const auto row : rows) {
+            for (int byte = 0; byte < 4; byte++) {
+                hash ^= (row >> (byte * 8)) & 0xFF;
+                hash *= 16777619u;
+            }
+        }
+        return hash;
+    }
+
+    template<auto IsWall>
+    std::vector<int> openCells() {
+        std::vector<int> cells;
+        for (int y = 0; y < WORLD_ROWS; y++) {
+            for (int x = 0; x < WORLD_COLUMNS; x++) {
+                if (!IsWall(x, y)) { cells.push_back(cellIndex(x, y)); }
+            }
+        }
+        return cells;
+    }
+
+    // Visibility is symmetric and every cell sees itself, so we only store the pairs (a, b) of open cells with a < b:
+    // the upper triangle of the open cell matrix, 8 pairs per byte. About a tenth of the full matrix for our map.
+    inline std::vector<uint8_t> compress(const Matrix& visible, std::span<const int> open) {
+        std::vector<uint8_t> bytes;
+        size_t bit = 0;
+        for (size_t a = 0; a < open.size(); a++) {
+            for (size_t b = a + 1; b < open.size(); b++, bit++) {
+                if ((bit & 7) == 0) { bytes.push_back(0); }
+                if (visible[open[a]][open[b]]) { bytes.back() |= static_cast<uint8_t>(1u << (bit & 7)); }
+            }
+        }
+        return bytes;
+    }
+
+    inline bool decompress(std::span<const uint8_t> bytes, std::span<const int> open, Matrix& visible) noexcept {
+        const size_t pairs = open.size() * (open.size() - 1) / 2;
+        if (bytes.size() != (pairs + 7) / 8) { return false; }
+        visible = {};
+        size_t bit = 0;
+        for (size_t a = 0; a < open.size(); a++) {
+            visible[open[a]][open[a]] = true;
+            for (size_t b = a + 1; b < open.size(); b++, bit++) {
+                if ((bytes[bit >> 3] >> (bit & 7)) & 1) {
+                    visible[open[a]][open[b]] = true;
+                    visible[open[b]][open[a]] = true;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// The level's PVS, decompressed once at load into a full bit matrix (8 KB), so a query is a single bit test.
+class PotentiallyVisibleSet {
+    PVS::Matrix _visible{};
+
+public:
+    // data and level_hash come from a generated header, eg. LevelPVS::DATA. Throws if they were built for a different map.
+    template<auto IsWall>
+    static PotentiallyVisibleSet load(std::span<const uint8_t> data, uint32_t level_hash) {
+        if (level_hash != PVS::levelHash(GridTraversal::wallRows<IsWall>())) {
+            throw std::runtime_error("PotentiallyVisibleSet: the PVS was built for a different map. Regenerate it with 'RayCastBench pvs'.");
+        }
+        PotentiallyVisibleSet pvs;
+        if (!PVS::decompress(data, PVS::openCells<IsWall>(), pvs._visible)) {
+            throw std::runtime_error("PotentiallyVisibleSet: the PVS data doesn't match the map's open cells. Regenerate it with 'RayCastBench pvs'.");
+        }
+        return pvs;
+    }
+
+    //is any part of cell (bx, by) possibly visible from anywhere in cell (ax, ay)? Cell coordinates, not world units.
+    bool possiblyVisible(int ax, int ay, int bx, int by) const noexcept {
+        assert(ax >= 0 && ax < WORLD_COLUMNS && ay >= 0 && ay < WORLD_ROWS && "PotentiallyVisibleSet: cell out of bounds");
+        assert(bx >= 0 && bx < WORLD_COLUMNS && by >= 0 && by < WORLD_ROWS && "PotentiallyVisibleSet: cell out of bounds");
+        return _visible[cellIndex(ax, ay)][cellIndex(bx, by)];
+    }
+
+    //everything visible from one cell, eg. to intersect with the cells that hold entities
+    const CellSet& visibleFrom(int x, int y) const noexcept {
+        assert(x >= 0 && x < WORLD_COLUMNS && y >= 0 && y < WORLD_ROWS && "PotentiallyVisibleSet: cell out of bounds");
+        return _visible[cellIndex(x, y)];
+    }
+};
+
+#include "LevelPVS.h"
+//the game's map. Throws if LevelPVS.h is out of date.
+inline PotentiallyVisibleSet loadLevelPVS() {
+    return PotentiallyVisibleSet::load<isWall>(LevelPVS::DATA, LevelPVS::LEVEL_HASH);
+}
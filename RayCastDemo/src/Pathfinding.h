@@ -0,0 +1,285 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include "BitGrid.h"
+// Single-agent shortest paths on a BitGrid, 8-connected. Diagonal moves may not cut corners: both cells beside
+// the diagonal must be open. Many agents heading for the same goal should share a FlowField instead.
+namespace Pathfinding {
+	struct Point {
+		int x = 0, y = 0;
+		bool operator==(const Point&) const noexcept = default;
+	};
+
+	static constexpr float DIAGONAL_COST = 1.41421356f;
+
+	inline float octile(const Point& a, const Point& b) noexcept { //exact cost of an unobstructed path, and our heuristic
+		const int dx = std::abs(a.x - b.x);
+		const int dy = std::abs(a.y - b.y);
+		return static_cast<float>(std::max(dx, dy)) + (DIAGONAL_COST - 1.0f) * static_cast<float>(std::min(dx, dy));
+	}
+
+	inline float pathCost(const std::vector<Point>& path) noexcept { //waypoints are joined by straight or diagonal lines
+		float cost = 0.0f;
+		for (size_t i = 1; i < path.size(); i++) {
+			cost += octile(path[i - 1], path[i]);
+		}
+		return cost;
+	}
+
+	// Per-cell search state, reused between queries. A stamp per node marks which query last touched it,
+	// so starting a search doesn't clear anything.
+	class SearchSpace {
+		struct Node {
+			float g = -1.0f; //-1: not reached yet
+			int parent = -1;
+			uint32_t stamp = 0;
+			bool closed = false;
+		};
+		struct Open {
+			float f = 0.0f;
+			float g = 0.0f;
+			int cell = 0;
+			bool operator>(const Open& that) const noexcept { //lowest f first, then the deepest node
+				return f > that.f || (f == that.f && g < that.g);
+			}
+		};
+		std::vector<Node> _nodes;
+		std::vector<Open> _open; //binary heap. Improved nodes are pushed again, stale entries are skipped on pop.
+		uint32_t _stamp = 0;
+		int _width = 0;
+
+		Node& node(int cell) noexcept {
+			auto& n = _nodes[cell];
+			if (n.stamp != _stamp) { n = { -1.0f, -1, _stamp, false }; }
+			return n;
+		}
+
+	public:
+		int expanded = 0; //nodes taken off the open list by the last search
+
+		void begin(const BitGrid& grid) {
+			_width = grid.width();
+			_nodes.resize(static_cast<size_t>(grid.width()) * grid.height());
+			_open.clear();
+			expanded = 0;
+			if (++_stamp == 0) { //wrapped: forget every old stamp
+				std::fill(_nodes.begin(), _nodes.end(), Node{});
+				_stamp = 1;
+			}
+		}
+		int cell(const Point& p) const noexcept { return p.y * _width + p.x; }
+		Point point(int cell) const noexcept { return { cell % _width, cell / _width }; }
+
+		void push(const Point& p, float g, int parent, const Point& goal) {
+			auto& n = node(cell(p));
+			if (n.closed || (n.g >= 0.0f && n.g <= g)) { return; }
+			n.g = g;
+			n.parent = parent;
+			_open.push_back({ g + octile(p, goal), g, cell(p) });
+			std::push_heap(_open.begin(), _open.end(), std::greater<>{});
+		}
+		//the next node to expand, or -1 when the open list is empty
+		int pop() noexcept {
+			while (!_open.empty()) {
+				std::pop_heap(_open.begin(), _open.end(), std::greater<>{});
+				const auto top = _open.back();
+				_open.pop_back();
+				auto& n = node(top.cell);
+				if (n.closed || top.g > n.g) { continue; } //stale
+				n.closed = true;
+				expanded++;
+				return top.cell;
+			}
+			return -1;
+		}
+		float g(int cell) noexcept { return node(cell).g; }
+		int parent(int cell) noexcept { return node(cell).parent; }
+
+		void buildPath(int goal, std::vector<Point>& path) {
+			path.clear();
+			for (int c = goal; c != -1; c = parent(c)) {
+				path.push_back(point(c));
+			}
+			std::reverse(path.begin(), path.end());
+		}
+	};
+
+	//can we step from p in direction (dx, dy)? No corner cutting.
+	inline bool canStep(const BitGrid& grid, const Point& p, int dx, int dy) noexcept {
+		if (!grid.isOpen(p.x + dx, p.y + dy)) { return false; }
+		return dx == 0 || dy == 0 || (grid.isOpen(p.x + dx, p.y) && grid.isOpen(p.x, p.y + dy));
+	}
+}
+
+// Plain A*, one cell at a time. The baseline for JumpPointSearch.
+class GridAStar {
+	Pathfinding::SearchSpace _space;
+
+public:
+	// fills path with every cell from start to goal. Returns false (and an empty path) if there is no way through.
+	bool find(const BitGrid& grid, Pathfinding::Point start, Pathfinding::Point goal, std::vector<Pathfinding::Point>& path) {
+		using namespace Pathfinding;
+		path.clear();
+		if (!grid.isOpen(start.x, start.y) || !grid.isOpen(goal.x, goal.y)) { return false; }
+		_space.begin(grid);
+		_space.push(start, 0.0f, -1, goal);
+		for (int current = _space.pop(); current != -1; current = _space.pop()) {
+			const Point p = _space.point(current);
+			if (p == goal) {
+				_space.buildPath(current, path);
+				return true;
+			}
+			const float g = _space.g(current);
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					if ((dx == 0 && dy == 0) || !canStep(grid, p, dx, dy)) { continue; }
+					_space.push({ p.x + dx, p.y + dy }, g + ((dx != 0 && dy != 0) ? DIAGONAL_COST : 1.0f), current, goal);
+				}
+			}
+		}
+		return false;
+	}
+	int expanded() const noexcept { return _space.expanded; }
+};
+
+// Jump point search (Harabor & Grastien), the variant without corner cutting. Instead of expanding every cell,
+// it jumps along straight lines until something interesting happens: a wall, the goal, or a "forced neighbour"
+// that only this line can reach optimally. Straight jumps scan 64 cells per step over the row (or column) bitmaps.
+class JumpPointSearch {
+	using Word = BitGrid::Word;
+	static constexpr int NONE = -1;
+	Pathfinding::SearchSpace _space;
+
+	// Scan line from position from, in direction step (+-1), for the first cell that ends a straight jump:
+	// blocked (no jump point), the goal, or a cell with a forced neighbour on side a or b: open there, but blocked
+	// beside the cell we came from. a and b are the neighbouring lines, null past the edge of the grid.
+	static int scanLine(const Word* line, const Word* a, const Word* b, int words, int length, int from, int step, int goal) noexcept {
+		if (from < 0 || from >= length) { return NONE; }
+		static constexpr int BITS = BitGrid::WORD_BITS;
+		for (int w = from / BITS; w >= 0 && w < words; w += step) {
+			const Word side_a = a ? a[w] : 0;
+			const Word side_b = b ? b[w] : 0;
+			Word behind_a, behind_b; //the side cells one step back, lined up with side_a and side_b
+			if (step > 0) {
+				behind_a = (side_a << 1) | ((a && w > 0) ? a[w - 1] >> (BITS - 1) : 0);
+				behind_b = (side_b << 1) | ((b && w > 0) ? b[w - 1] >> (BITS - 1) : 0);
+			}
+			else {
+				behind_a = (side_a >> 1) | ((a && w + 1 < words) ? a[w + 1] << (BITS - 1) : 0);
+				behind_b = (side_b >> 1) | ((b && w + 1 < words) ? b[w + 1] << (BITS - 1) : 0);
+			}
+			Word stop = ~line[w] | (side_a & ~behind_a) | (side_b & ~behind_b);
+			if (goal != NONE && goal / BITS == w) { stop |= Word{ 1 } << (goal % BITS); }
+			if (w == from / BITS) { //ignore the cells behind from
+				stop &= (step > 0) ? (~Word{ 0 } << (from % BITS)) : (~Word{ 0 } >> (BITS - 1 - from % BITS));
+			}
+			if (stop == 0) { continue; } //64 open, unremarkable cells in one go
+			const int found = (step > 0) ? w * BITS + std::countr_zero(stop) : w * BITS + (BITS - 1 - std::countl_zero(stop));
+			const bool open = (found < length) && ((line[w] >> (found % BITS)) & 1);
+			return open ? found : NONE;
+		}
+		return NONE;
+	}
+
+	//jump from p (exclusive) along a row or column. Returns the jump point's position along that line, or NONE.
+	static int jumpStraight(const BitGrid& grid, const Pathfinding::Point& p, int dx, int dy, const Pathfinding::Point& goal) noexcept {
+		if (dy == 0) {
+			const Word* above = (p.y > 0) ? grid.row(p.y - 1) : nullptr;
+			const Word* below = (p.y + 1 < grid.height()) ? grid.row(p.y + 1) : nullptr;
+			return scanLine(grid.row(p.y), above, below, grid.rowWords(), grid.width(), p.x + dx, dx, (goal.y == p.y) ? goal.x : NONE);
+		}
+		const Word* left = (p.x > 0) ? grid.column(p.x - 1) : nullptr;
+		const Word* right = (p.x + 1 < grid.width()) ? grid.column(p.x + 1) : nullptr;
+		return scanLine(grid.column(p.x), left, right, grid.columnWords(), grid.height(), p.y + dy, dy, (goal.x == p.x) ? goal.y : NONE);
+	}
+
+	//follow a diagonal one cell at a time. Stop where a straight jump from it would find something.
+	static bool jumpDiagonal(const BitGrid& grid, Pathfinding::Point& p, int dx, int dy, const Pathfinding::Point& goal) noexcept {
+		while (Pathfinding::canStep(grid, p, dx, dy)) {
+			p = { p.x + dx, p.y + dy };
+			if (p == goal || jumpStraight(grid, p, dx, 0, goal) != NONE || jumpStraight(grid, p, 0, dy, goal) != NONE) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void jump(const BitGrid& grid, const Pathfinding::Point& from, int current, int dx, int dy, const Pathfinding::Point& goal) {
+		using namespace Pathfinding;
+		Point to = from;
+		if (dx != 0 && dy != 0) {
+			if (!jumpDiagonal(grid, to, dx, dy, goal)) { return; }
+		}
+		else {
+			const int found = jumpStraight(grid, from, dx, dy, goal);
+			if (found == NONE) { return; }
+			(dy == 0 ? to.x : to.y) = found;
+		}
+		_space.push(to, _space.g(current) + octile(from, to), current, goal);
+	}
+
+	//the directions worth jumping in from p, having arrived moving (dx, dy). Everything else is reached better another way.
+	void successors(const BitGrid& grid, const Pathfinding::Point& p, int current, const Pathfinding::Point& goal) {
+		using namespace Pathfinding;
+		const int parent = _space.parent(current);
+		if (parent == -1) { //the start: every direction
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					if ((dx != 0 || dy != 0) && canStep(grid, p, dx, dy)) { jump(grid, p, current, dx, dy, goal); }
+				}
+			}
+			return;
+		}
+		const Point from = _space.point(parent);
+		const int dx = (p.x > from.x) - (p.x < from.x);
+		const int dy = (p.y > from.y) - (p.y < from.y);
+		auto tryJump = [&](int jx, int jy) {
+			if (canStep(grid, p, jx, jy)) { jump(grid, p, current, jx, jy, goal); }
+		};
+		if (dx != 0 && dy != 0) {
+			tryJump(dx, 0);
+			tryJump(0, dy);
+			tryJump(dx, dy);
+		}
+		else if (dx != 0) {
+			tryJump(dx, 0);
+			tryJump(dx, 1);
+			tryJump(dx, -1);
+			tryJump(0, 1); //forced: blocked behind, so only this row gets there in time
+			tryJump(0, -1);
+		}
+		else {
+			tryJump(0, dy);
+			tryJump(1, dy);
+			tryJump(-1, dy);
+			tryJump(1, 0);
+			tryJump(-1, 0);
+		}
+	}
+
+public:
+	// fills path with the jump points from start to goal, joined by straight or diagonal lines.
+	// Returns false (and an empty path) if there is no way through.
+	bool find(const BitGrid& grid, Pathfinding::Point start, Pathfinding::Point goal, std::vector<Pathfinding::Point>& path) {
+		using namespace Pathfinding;
+		path.clear();
+		if (!grid.isOpen(start.x, start.y) || !grid.isOpen(goal.x, goal.y)) { return false; }
+		_space.begin(grid);
+		_space.push(start, 0.0f, -1, goal);
+		for (int current = _space.pop(); current != -1; current = _space.pop()) {
+			const Point p = _space.point(current);
+			if (p == goal) {
+				_space.buildPath(current, path);
+				return true;
+			}
+			successors(grid, p, current, goal);
+		}
+		return false;
+	}
+	int expanded() const noexcept { return _space.expanded; }
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+// A handle to an object in a Pool. Stays safe to hold after the object is destroyed: the slot's generation moves on,
+// so the stale handle simply stops resolving, even once the slot is reused. Handle{} never resolves.
+struct Handle {
+	uint32_t index = 0;
+	uint32_t generation = 0;
+	constexpr bool operator==(const Handle&) const noexcept = default;
+};
+
+// Fixed-capacity storage for short-lived objects (projectiles, sprites, agents), instead of allocating each one.
+// Objects live packed at the front of one array, in no particular order, so iterating them is a dense loop. Handles go
+// through a slot table to find them in O(1): destroying an object moves the last one into its place and re-points that
+// one's slot. Free slots are kept on an intrusive free list. Everything is sized at construction; nothing allocates after.
+template<typename T>
+class Pool {
+	static constexpr uint32_t NONE = UINT32_MAX;
+	struct Slot {
+		uint32_t dense = NONE; //where the object is in _items. While free: the next free slot.
+		uint32_t generation = 1; //0 is Handle{}
+	};
+	std::vector<T> _items; //dense
+	std::vector<uint32_t> _owners; //the slot of each item
+	std::vector<Slot> _slots;
+	uint32_t _free = NONE; //head of the free list
+
+	void release(size_t dense) noexcept {
+		const uint32_t slot = _owners[dense];
+		const size_t last = _items.size() - 1;
+		if (dense != last) {
+			_items[dense] = std::move(_items[last]);
+			_owners[dense] = _owners[last];
+			_slots[_owners[dense]].dense = static_cast<uint32_t>(dense);
+		}
+		_items.pop_back();
+		_owners.pop_back();
+		auto& s = _slots[slot];
+		s.generation = (s.generation == UINT32_MAX) ? 1 : s.generation + 1; //every handle to it goes stale
+		s.dense = _free;
+		_free = slot;
+	}
+
+public:
+	explicit Pool(size_t capacity) : _slots(capacity) {
+		assert(capacity < NONE);
+		_items.reserve(capacity);
+		_owners.reserve(capacity);
+		for (size_t i = capacity; i-- > 0;) { //so slots are handed out in order
+			_slots[i].dense = _free;
+			_free = static_cast<uint32_t>(i);
+		}
+	}
+
+	// Returns Handle{} when the pool is full.
+	template<typename... Args>
+	Handle create(Args&&... args) {
+		if (_free == NONE) { return Handle{}; }
+		const uint32_t slot = _free;
+		auto& s = _slots[slot];
+		_free = s.dense;
+		s.dense = static_cast<uint32_t>(_items.size());
+		_items.emplace_back(std::forward<Args>(args)...); //within the reserved capacity: never reallocates
+		_owners.push_back(slot);
+		return Handle{ slot, s.generation };
+	}
+	// Returns false if the handle was already stale.
+	bool destroy(Handle h) noexcept {
+		if (!contains(h)) { return false; }
+		release(_slots[h.index].dense);
+		return true;
+	}
+	void clear() noexcept {
+		while (!_items.empty()) { release(_items.size() - 1); }
+	}
+
+	bool contains(Handle h) const noexcept {
+		return h.index < _slots.size() && _slots[h.index].generation == h.generation && h.generation != 0;
+	}
+	T* get(Handle h) noexcept { return contains(h) ? &_items[_slots[h.index].dense] : nullptr; }
+	const T* get(Handle h) const noexcept { return contains(h) ? &_items[_slots[h.index].dense] : nullptr; }
+	Handle handleAt(size_t dense) const noexcept {
+		assert(dense < _items.size());
+		const uint32_t slot = _owners[dense];
+		return Handle{ slot, _slots[slot].generation };
+	}
+
+	// Destroy every object fn(object) returns true for. One dense pass; fn may update the objects it keeps.
+	template<typename Fn>
+	void removeIf(const Fn& fn) {
+		for (size_t i = 0; i < _items.size();) {
+			if (fn(_items[i])) { release(i); } //the last object moved into i: look at it next
+			else { i++; }
+		}
+	}
+
+	std::span<T> items() noexcept { return _items; }
+	std::span<const T> items() const noexcept { return _items; }
+	size_t size() const noexcept { return _items.size(); }
+	size_t capacity() const noexcept { return _slots.size(); }
+	bool full() const noexcept { return _free == NONE; }
+	bool empty() const noexcept { return _items.empty(); }
+};
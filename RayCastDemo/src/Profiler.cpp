@@ -0,0 +1,60 @@
+#include "Profiler.h"
+#ifdef USE_PROFILER
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Profiler {
+	//zones closest to the writer's head may be overwritten while we dump from another thread, so leave those out.
+	static constexpr uint32_t DUMP_SAFETY_MARGIN = 1024;
+
+	namespace {
+		std::mutex registryMutex; //only taken when a thread records its first zone, and when dumping
+		std::vector<std::unique_ptr<ThreadBuffer>> registry; //buffers are kept until exit, so we can dump zones from finished threads
+
+		ThreadBuffer* registerThread() {
+			std::scoped_lock lock(registryMutex);
+			registry.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(registry.size() + 1)));
+			return registry.back().get();
+		}
+	}
+
+	ThreadBuffer& localBuffer() noexcept {
+		thread_local ThreadBuffer* buffer = registerThread();
+		return *buffer;
+	}
+
+	void setThreadName(const char* name) noexcept {
+		localBuffer().name = name;
+	}
+
+	bool dumpChromeTrace(std::string_view path) {
+		std::ofstream out{ std::string(path) };
+		if (!out) {
+			return false;
+		}
+		const Uint64 origin = Timer::now(); //earliest timestamp becomes 0
+		std::scoped_lock lock(registryMutex);
+		Uint64 first = origin;
+		for (const auto& buffer : registry) {
+			buffer->forEach([&first](const Zone& z) { first = (z.start < first) ? z.start : first; }, DUMP_SAFETY_MARGIN);
+		}
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool comma = false;
+		for (const auto& buffer : registry) {
+			out << (comma ? ",\n" : "") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+				<< ",\"args\":{\"name\":\"" << buffer->name.load() << "\"}}";
+			comma = true;
+			buffer->forEach([&out, &buffer, first](const Zone& z) {
+				const auto start_us = Timer::toMicroseconds(z.start - first);
+				const auto duration_us = Timer::toMicroseconds(z.end - z.start);
+				out << ",\n{\"name\":\"" << z.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+					<< ",\"ts\":" << start_us << ",\"dur\":" << duration_us << "}";
+			}, DUMP_SAFETY_MARGIN);
+		}
+		out << "\n]}\n";
+		return out.good();
+	}
+}
+#endif //USE_PROFILER
@@ -0,0 +1,77 @@
+#pragma once
+#include "Config.h"
+// Scoped frame profiler. Wrap a block in PROFILE_ZONE("name") to time it, then call Profiler::dumpChromeTrace()
+// to get a trace_event JSON you can open in chrome://tracing or https://ui.perfetto.dev
+// Each thread records into its own fixed-size ring buffer (no locks, no allocations while recording).
+// Without USE_PROFILER (see Config.h) the macros expand to nothing, and there is no cost at all.
+#ifdef USE_PROFILER
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "Timer.h"
+namespace Profiler {
+	struct Zone {
+		const char* name = nullptr; //must be a string literal (or otherwise outlive the profiler)
+		Uint64 start = 0;
+		Uint64 end = 0;
+	};
+
+	class ThreadBuffer {
+	public:
+		static constexpr uint32_t CAPACITY = 1 << 14; //zones per thread. Older zones are overwritten.
+		static_assert(Utils::isPowerOfTwo(CAPACITY));
+	private:
+		std::array<Zone, CAPACITY> _zones{};
+		std::atomic<uint32_t> _head{ 0 }; //total zones written. Only the owning thread writes.
+	public:
+		const uint32_t id;
+		std::atomic<const char*> name{ "thread" };
+		explicit ThreadBuffer(uint32_t threadId) noexcept : id(threadId) {}
+		void record(const char* zone, Uint64 start, Uint64 end) noexcept {
+			const auto head = _head.load(std::memory_order_relaxed);
+			_zones[head & (CAPACITY - 1)] = Zone{ zone, start, end };
+			_head.store(head + 1, std::memory_order_release);
+		}
+		template<typename Visitor>
+		void forEach(Visitor&& visit, uint32_t safety_margin) const { //safe to call from another thread, see Profiler.cpp
+			const auto head = _head.load(std::memory_order_acquire);
+			const auto available = (head < CAPACITY - safety_margin) ? head : CAPACITY - safety_margin;
+			for (auto i = head - available; i != head; i++) {
+				visit(_zones[i & (CAPACITY - 1)]);
+			}
+		}
+	};
+
+	ThreadBuffer& localBuffer() noexcept;
+	inline const char*& currentZone() noexcept { //the innermost zone open on this thread, or nullptr. See HeapCounter.
+		thread_local const char* zone = nullptr;
+		return zone;
+	}
+	void setThreadName(const char* name) noexcept;
+	bool dumpChromeTrace(std::string_view path);
+
+	class ScopedZone {
+		const char* _name;
+		const char* _parent;
+		Uint64 _start;
+	public:
+		explicit ScopedZone(const char* name) noexcept : _name(name), _parent(currentZone()), _start(Timer::now()) {
+			currentZone() = name;
+		}
+		~ScopedZone() {
+			localBuffer().record(_name, _start, Timer::now());
+			currentZone() = _parent;
+		}
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+	};
+}
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) const Profiler::ScopedZone PROFILE_CONCAT(profile_zone_, __LINE__){ name }
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif //USE_PROFILER
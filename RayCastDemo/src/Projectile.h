@@ -0,0 +1,33 @@
+#pragma once
+#include "Config.h"
+#include "Graphics.h"
+#include "LevelData.h"
+#include "Movement.h"
+#include "Sprite.h"
+// A shot that flies straight until it hits a wall or runs out of time. Kept in a Pool, see Simulation.
+struct Projectile {
+	int x = 0, y = 0;
+	int mx = 0, my = 0; //per tick
+	int ticksLeft = Cfg::PROJECTILE_TICKS;
+	int movedX = 0, movedY = 0; //during the last tick
+
+	static Projectile fire(int x, int y, int angle) noexcept {
+		const auto& step = Movement::WALK[angle];
+		constexpr float SCALE = static_cast<float>(Cfg::PROJECTILE_SPEED) / Cfg::WALK_SPEED;
+		return Projectile{ x, y, static_cast<int>(step.dx * SCALE), static_cast<int>(step.dy * SCALE) };
+	}
+
+	// Returns false once it has hit a wall or expired, and should be destroyed.
+	template<typename IsWall>
+	bool update(const IsWall& isWall) noexcept {
+		const int fromX = x, fromY = y;
+		const int blocked = Movement::sweep(x, y, mx, my, Cfg::PROJECTILE_RADIUS, isWall); //swept, so even fast shots can't pass through a wall
+		movedX = x - fromX;
+		movedY = y - fromY;
+		return blocked == 0 && --ticksLeft > 0;
+	}
+
+	Sprite sprite() const noexcept {
+		return Sprite{ x, y, movedX, movedY, Cfg::PROJECTILE_RADIUS * 2, paletteIndexOf(Yellow) };
+	}
+};
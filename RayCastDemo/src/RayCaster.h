@@ -1,6 +1,8 @@
 #pragma once
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <span>
 #include "Config.h"
 #include "LevelData.h"
 #include "Graphics.h"
@@ -8,25 +10,32 @@
 #include "Utils.h"
 #include "StringUtils.h"
 #include "MiniMap.h"
+#include "ColorMap.h"
+#include "Profiler.h"
+#include "RayStats.h"
+#include "GridTraversal.h"
+#include "Sprite.h"
+#include "FrameArena.h"
 
-class RayCaster {    
-    struct RayStart {
-        float intersection = 0.0f; //the first possible intersection point
-        int boundary = 0; // the next intersection point   
-        int delta = 0; // the amount needed to move to get to the next cell position
-        int next_cell = 0; //cell delta, to move left / right or up / down
-    };
-    struct RayEnd {
-        float distance = 0.0f; // the distance of intersection from the player
-        int boundary = 0; // record intersections with cell boundaries        
-        int intersection = 0; // used to save exact intersection point with a wall         
-        bool operator <(const RayEnd& that) const noexcept { return distance < that.distance; };
-    };    
-    static constexpr auto WALL_BOUNDARY_COLOR = White;
-    static constexpr auto VERTICAL_WALL_COLOR = LightGreen;
-    static constexpr auto HORIZONTAL_WALL_COLOR = DarkGreen;  
-    static constexpr auto CEILING_COLOR = Gray;
-    static constexpr auto FLOOR_COLOR = Brown;
+//the result of casting along one axis. Shared by every RayCaster instantiation so kernels can be compared against each other.
+struct RayEnd {
+    float distance = 0.0f; // the distance of intersection from the player
+    int boundary = 0; // record intersections with cell boundaries        
+    int intersection = 0; // used to save exact intersection point with a wall         
+    bool operator <(const RayEnd& that) const noexcept { return distance < that.distance; };
+};
+
+// IsWall is the map lookup, eg. LevelBitmap::isWall. The game uses RayCaster (below), the benchmark instantiates the others.
+template<auto IsWall>
+class BasicRayCaster {    
+    using AxisWalk = GridTraversal::AxisWalk;
+    //wall colors are palette indices, so they can be shaded through the colormap
+    static constexpr auto WALL_BOUNDARY_COLOR = paletteIndexOf(White);
+    static constexpr auto VERTICAL_WALL_COLOR = paletteIndexOf(LightGreen);
+    static constexpr auto HORIZONTAL_WALL_COLOR = paletteIndexOf(DarkGreen);
+    static constexpr auto CEILING_COLOR = paletteIndexOf(Gray);
+    static constexpr auto FLOOR_COLOR = paletteIndexOf(Brown);
+    static constexpr auto VIEWPORT_BORDER_COLOR = paletteIndexOf(DarkRed);
     //320x240@60fov = K15000, 128x64@60fov = K7000
     static constexpr auto K = 7000.0f;// think of K as a combination of view distance and aspect ratio. Pick a value that looks good. In my case: that makes the block on screen look square.          
     //The MAGIC_CONSTANT must be an even power-of-two >= WORLD_SIZE. Used to quickly round our position to nearest cell wall using bitwise AND.
@@ -47,6 +56,21 @@ class RayCaster {
 
     // cos table used to fix view distortion caused by radial projection (eg: cancel out fishbowl effect)
     std::array<float, HALF_FOV_ANGLE * 2> cos_table;
+
+    // pre-shaded palette and distance -> light level table, for distance shading
+    ColorMap colormap{};
+
+    // runtime render resolution. The angle tables above are built once, for the full VIEWPORT_WIDTH. A narrower view
+    // steps through them with a 16.16 fixed-point stride instead, so changing resolution never rebuilds a table.
+    static constexpr auto FIXED_ONE = 1 << 16;
+    int view_width = Cfg::VIEWPORT_WIDTH;
+    int view_height = Cfg::VIEWPORT_HEIGHT;
+    int column_stride = FIXED_ONE; //table angles per rendered column, in 16.16 fixed point
+    float height_scale = 1.0f; //K (in cos_table) is tuned for VIEWPORT_HEIGHT
+
+    mutable RayStats stats{}; //only touched when Cfg::hasRayStats()
+    mutable CellSet visible_cells{}; //only touched when Cfg::hasVisibleCells()
+    mutable std::array<float, Cfg::VIEWPORT_WIDTH> depth_buffer{}; //distance to the wall drawn in each column, for the sprite pass
        
     constexpr inline bool isFacingLeft(const int view_angle) const noexcept {
         return (view_angle >= ANGLE_90 && view_angle < ANGLE_270);
@@ -100,71 +124,115 @@ class RayCaster {
         }
     }
 
-    inline RayStart initHorizontalRay(const int x, const int y, const int view_angle) const noexcept {        
+    inline AxisWalk initHorizontalRay(const int x, const int y, const int view_angle) const noexcept {        
         const auto FACING_RIGHT = isFacingRight(view_angle);        
         const int x_bound = FACING_RIGHT ? CELL_SIZE + (x & MAGIC_CONSTANT) : (x & MAGIC_CONSTANT); //round x to nearest CELL_WIDTH (power-of-2), this is the first possible intersection point. 
         const int x_delta = FACING_RIGHT ? CELL_SIZE : -CELL_SIZE; // the amount needed to move to get to the next vertical line (cell boundary)
         const int next_cell_direction = FACING_RIGHT ? 0 : -1;  //x coordinates increase to the left, and decrease to the right      
         const float yi = tan_table[view_angle] * (x_bound - x) + y; // based on first possible vertical intersection line, compute Y intercept, so that casting can begin                                
-        return RayStart{ yi, x_bound, x_delta, next_cell_direction };
+        return AxisWalk{ yi, y_step[view_angle], x_bound, x_delta, next_cell_direction };
     }
 
-    inline RayStart initVerticalRay(const int x, const int y, const int view_angle) const noexcept {
+    inline AxisWalk initVerticalRay(const int x, const int y, const int view_angle) const noexcept {
         const auto FACING_DOWN = isFacingDown(view_angle);
         const int y_bound = FACING_DOWN ? CELL_SIZE  + (y & MAGIC_CONSTANT) : (y & MAGIC_CONSTANT); //Optimization: round y to nearest CELL_HEIGHT (power-of-2) 
         const int y_delta = FACING_DOWN ? CELL_SIZE : -CELL_SIZE; // the amount needed to move to get to the next horizontal line (cell boundary)
         const int next_cell_direction = FACING_DOWN ? 0 : -1; //remember: y coordinates increase as we move down (south) in the world, and decrease towards the top (north)               
         const float xi = inv_tan_table[view_angle] * (y_bound - y) + x; // based on first possible horizontal intersection line, compute X intercept, so that casting can begin              
-        return RayStart{ xi, y_bound, y_delta, next_cell_direction };
+        return AxisWalk{ xi, x_step[view_angle], y_bound, y_delta, next_cell_direction };
     }
 
-    RayEnd findVerticalWall(const int x, const int y, const int view_angle) const noexcept  {    
-        auto [yi,  x_bound, x_delta, next_x_cell] = initHorizontalRay(x, y, view_angle); // cast a ray horizontally, along the x-axis, to intersect with vertical walls
-        RayEnd result;
-        while (x_bound > -1 && x_bound < WORLD_SIZE) {
-            const int cell_x = ((x_bound + next_x_cell) >> CELL_SIZE_FP); //Optimization: shift instead of divide, might help the Arduboy
-            const int cell_y = static_cast<int>(yi) >> CELL_SIZE_FP;                   
-            if (!isWall(cell_x, cell_y)) {
-                yi += y_step[view_angle]; // compute next Y intercept
-                x_bound += x_delta; // move to next possible intersection points
-                continue;
+    void clearView(const Graphics& g) const noexcept {        
+        PROFILE_ZONE("RayCaster::clearView");
+        const auto right = VIEWPORT_LEFT + view_width;
+        const auto bottom = VIEWPORT_TOP + view_height;
+        const auto horizon = VIEWPORT_TOP + (view_height >> 1);
+        g.setColor(CEILING_COLOR);
+        g.drawRectangle(RectStyle::FILL, VIEWPORT_LEFT, VIEWPORT_TOP, right, horizon);
+        g.setColor(FLOOR_COLOR);
+        g.drawRectangle(RectStyle::FILL, VIEWPORT_LEFT, horizon, right, bottom);
+        g.setColor(VIEWPORT_BORDER_COLOR);
+        g.drawRectangle(RectStyle::OUTLINE, VIEWPORT_LEFT - 1, VIEWPORT_TOP - 1, right + 1, bottom + 1); //debugging: draw a rect around the viewport so we can see overdraw.
+    }
+
+    static constexpr int wrapAngle(int angle) noexcept {
+        if (angle < ANGLE_0) { return angle + ANGLE_360; }
+        if (angle >= ANGLE_360) { return angle - ANGLE_360; }
+        return angle;
+    }
+
+    //cast and draw columns [first, last) of the view centered on view_angle
+    void castColumns(const Graphics& g, const int x, const int y, int view_angle, const int first, const int last) const noexcept {
+        int column_angle = first * column_stride; //offset from the starting angle, in 16.16 fixed point. At full resolution this is simply ray << 16.
+        view_angle = wrapAngle(view_angle - HALF_FOV_ANGLE + (column_angle >> 16)); // compute starting angle from player. Field of view is FOV angles, subtract half of that from the current view angle
+        const int horizon = VIEWPORT_TOP + (view_height >> 1);
+        for (int ray = first; ray < last; ray++) {
+            const int fov_index = column_angle >> 16;
+            if constexpr (Cfg::hasRayStats()) {
+                stats.beginRay();
+            }
+            RayEnd xray = findVerticalWall(x, y, view_angle);  //cast a ray along the x-axis to intersect with vertical walls
+            RayEnd yray = findHorizontalWall(x, y, view_angle); //cast a ray along the y-axis to intersect with horizontal walls
+            int color = WALL_BOUNDARY_COLOR;
+            const float min_dist = (xray < yray) ? xray.distance : yray.distance;           
+            depth_buffer[ray] = min_dist;
+            if constexpr (Cfg::hasRayStats()) {
+                stats.endRay();
+            }
+            if (xray < yray) { // there was a vertical wall closer than a horizontal wall                
+                if (xray.intersection % CELL_SIZE > 1) {
+                    color = VERTICAL_WALL_COLOR;                    
+                }
+                if constexpr (Cfg::hasMinimap()) {
+                    MiniMap::drawLine(g, x, y, xray.boundary, xray.intersection, color);
+                }
+                if constexpr (Cfg::hasVisibleCells()) {
+                    markVisible(x, y, xray.boundary, xray.intersection);
+                }
+            }
+            else { // must have hit a horizontal wall first                            
+                if (yray.intersection % CELL_SIZE > 1) {
+                    color = HORIZONTAL_WALL_COLOR;
+                }
+                if constexpr (Cfg::hasMinimap()) {
+                    MiniMap::drawLine(g, x, y, yray.intersection, yray.boundary, color);
+                }
+                if constexpr (Cfg::hasVisibleCells()) {
+                    markVisible(x, y, yray.intersection, yray.boundary);
+                }
+            }
+            // height of the sliver is based on the inverse distance to the intersection. Closer is bigger, so: height = 1/dist. However, 1 is too low a factor to look good. Thus the constant K which has been pre-multiplied into the view-filter lookup-table.
+            const int height = static_cast<int>(cos_table[fov_index] * height_scale / min_dist);
+            const int clipped_height = (height > view_height) ? view_height : height;
+            const int top = horizon - (clipped_height >> 1); //Optimization: height >> 1 == height / 2. slivers are drawn symmetrically around the viewport horizon.                       
+            const int sliver_x = ray;       
+            if constexpr (Cfg::hasDistanceShading()) {
+                color = ColorMap::index(colormap.lightLevel(min_dist), color);
+            }
+            g.setColor(color);
+            g.drawVerticalLine(sliver_x, top, clipped_height - 1);              
+            column_angle += column_stride;
+            if ((view_angle += (column_angle >> 16) - fov_index) >= ANGLE_360) { 
+                view_angle -= ANGLE_360; //wrap angle back to zero
             }
-            result.distance = (yi - y) * inv_sin_table[view_angle]; // compute distance to hit
-            result.boundary = x_bound; // record intersections with cell boundaries
-            result.intersection = static_cast<int>(yi);
-            return result;                        
-        }                
-        assert(false && "RayCaster: couldn't findVerticalWall(); Make sure isWall() returns true for out-of-bounds coordinates."); 
-        return result;          
-    }  
-  
-    RayEnd findHorizontalWall(const int x, const int y, const int view_angle) const noexcept {
-        auto [xi, y_bound, y_delta, next_y_cell] = initVerticalRay(x, y, view_angle); ///ast a ray vertically, along the y-axis, to intersect with horizontal walls
-        RayEnd result;
-        while (y_bound > -1 && y_bound < WORLD_SIZE) {
-            const int cell_x = static_cast<int>(xi) >> CELL_SIZE_FP;   // the current cell that the ray is in             
-            const int cell_y = ((y_bound + next_y_cell) >> CELL_SIZE_FP);
-            if (!isWall(cell_x, cell_y)) {
-                xi += x_step[view_angle]; //compute next X intercept
-                y_bound += y_delta;
-                continue;
-            }         
-            result.distance = (xi - x) * inv_cos_table[view_angle];
-            result.boundary = y_bound;
-            result.intersection = static_cast<int>(xi);                                        
-            return result;            
         }
-        assert(false && "RayCaster: couldn't findHorizontalWall(); Make sure isWall() returns true for out-of-bounds coordinates."); 
-        return result;
-    }         
+    }
 
-    void clearView(const Graphics& g) const noexcept {        
+    //every open cell on the way from the viewer to the wall a ray hit
+    void markVisible(const int x, const int y, const int hit_x, const int hit_y) const noexcept {
+        GridTraversal::forEachCell(x, y, hit_x, hit_y, [this](int cell_x, int cell_y) noexcept {
+            if (!IsWall(cell_x, cell_y)) { visible_cells[cellIndex(cell_x, cell_y)] = true; }
+        });
+    }
+
+    //clear behind columns [first, last), then cast them
+    void renderColumns(const Graphics& g, const int x, const int y, const int view_angle, const int first, const int last) const noexcept {
+        const auto horizon = VIEWPORT_TOP + (view_height >> 1);
         g.setColor(CEILING_COLOR);
-        g.drawRectangle(RectStyle::FILL, VIEWPORT_LEFT, VIEWPORT_TOP, VIEWPORT_RIGHT, VIEWPORT_HORIZON);
+        g.drawRectangle(RectStyle::FILL, VIEWPORT_LEFT + first, VIEWPORT_TOP, VIEWPORT_LEFT + last, horizon);
         g.setColor(FLOOR_COLOR);
-        g.drawRectangle(RectStyle::FILL, VIEWPORT_LEFT, VIEWPORT_HORIZON, VIEWPORT_RIGHT, VIEWPORT_BOTTOM);
-        g.setColor(DarkRed);
-        g.drawRectangle(RectStyle::OUTLINE, VIEWPORT_LEFT - 1, VIEWPORT_TOP - 1, VIEWPORT_RIGHT + 1, VIEWPORT_BOTTOM + 1); //debugging: draw a rect around the viewport so we can see overdraw.
+        g.drawRectangle(RectStyle::FILL, VIEWPORT_LEFT + first, horizon, VIEWPORT_LEFT + last, VIEWPORT_TOP + view_height);
+        castColumns(g, x, y, view_angle, first, last);
     }
 
     //convenience function to print the source code for each table. Useful on devices (eg. arduboy) where the LUTs won't fit in RAM and must be stored in progmem.
@@ -184,49 +252,183 @@ class RayCaster {
     }
     
 public:
-    RayCaster() {
+    BasicRayCaster() {
         buildLookupTables();
     } 
+
+    //the two wall searches that make up a ray. Public so they can be benchmarked and tested in isolation.
+    RayEnd findVerticalWall(const int x, const int y, const int view_angle) const noexcept  {    
+        auto walk = initHorizontalRay(x, y, view_angle); // cast a ray horizontally, along the x-axis, to intersect with vertical walls
+        RayEnd result;
+        while (walk.boundary > -1 && walk.boundary < WORLD_SIZE) {
+            if constexpr (Cfg::hasRayStats()) {
+                stats.visit(GridTraversal::cellX<true>(walk), GridTraversal::cellY<true>(walk));
+            }
+            if (!GridTraversal::hitsWall<IsWall, true>(walk)) {
+                GridTraversal::advance(walk); // compute next Y intercept, move to next possible intersection point
+                continue;
+            }
+            result.distance = (walk.intercept - y) * inv_sin_table[view_angle]; // compute distance to hit
+            result.boundary = walk.boundary; // record intersections with cell boundaries
+            result.intersection = static_cast<int>(walk.intercept);
+            return result;                        
+        }                
+        assert(false && "RayCaster: couldn't findVerticalWall(); Make sure isWall() returns true for out-of-bounds coordinates."); 
+        return result;          
+    }  
+  
+
+    RayEnd findHorizontalWall(const int x, const int y, const int view_angle) const noexcept {
+        auto walk = initVerticalRay(x, y, view_angle); //cast a ray vertically, along the y-axis, to intersect with horizontal walls
+        RayEnd result;
+        while (walk.boundary > -1 && walk.boundary < WORLD_SIZE) {
+            if constexpr (Cfg::hasRayStats()) {
+                stats.visit(GridTraversal::cellX<false>(walk), GridTraversal::cellY<false>(walk));
+            }
+            if (!GridTraversal::hitsWall<IsWall, false>(walk)) {
+                GridTraversal::advance(walk); //compute next X intercept, move to the next boundary
+                continue;
+            }         
+            result.distance = (walk.intercept - x) * inv_cos_table[view_angle];
+            result.boundary = walk.boundary;
+            result.intersection = static_cast<int>(walk.intercept);                                        
+            return result;            
+        }
+        assert(false && "RayCaster: couldn't findHorizontalWall(); Make sure isWall() returns true for out-of-bounds coordinates."); 
+        return result;
+    }
+
+
+    // render at width x height instead of the full viewport. The caller is responsible for scaling the result up to VIEWPORT_WIDTH x VIEWPORT_HEIGHT.
+    void setResolution(int width, int height) noexcept {
+        assert(width > 0 && width <= Cfg::VIEWPORT_WIDTH && height > 0 && height <= Cfg::VIEWPORT_HEIGHT);
+        view_width = width;
+        view_height = height;
+        column_stride = (Cfg::VIEWPORT_WIDTH * FIXED_ONE) / width;
+        height_scale = static_cast<float>(height) / Cfg::VIEWPORT_HEIGHT;
+    }
+    int width() const noexcept { return view_width; }
+    int height() const noexcept { return view_height; }
+
     void renderView(const Graphics& g, const int x, const int y, int view_angle) const noexcept {
-        // This function casts out RAY_COUNT rays from the viewer and builds up the display based on the intersections with the walls.
+        // This function casts out one ray per column (RAY_COUNT at full resolution) from the viewer and builds up the display based on the intersections with the walls.
         // The distance to the first horizontal and vertical edge is recorded. The closest intersection is the one used to draw the display.
         // The inverse of that distance is used to compute the height of the "sliver" of texture that will be drawn on the screen                
         clearView(g); //draw ceciling and floor first.
-        if ((view_angle -= HALF_FOV_ANGLE) < 0) { // compute starting angle from player. Field of view is FOV angles, subtract half of that from the current view angle
-            view_angle = ANGLE_360 + view_angle;
-        }      
-        for (int ray = 0; ray < RAY_COUNT; ray++) {
-            RayEnd xray = findVerticalWall(x, y, view_angle);  //cast a ray along the x-axis to intersect with vertical walls
-            RayEnd yray = findHorizontalWall(x, y, view_angle); //cast a ray along the y-axis to intersect with horizontal walls
-            SDL_Color color = WALL_BOUNDARY_COLOR;
-            const float min_dist = (xray < yray) ? xray.distance : yray.distance;           
-            if (xray < yray) { // there was a vertical wall closer than a horizontal wall                
-                if (xray.intersection % CELL_SIZE > 1) {
-                    color = VERTICAL_WALL_COLOR;                    
-                }
-                if constexpr (Cfg::hasMinimap()) {
-                    MiniMap::drawLine(g, x, y, xray.boundary, xray.intersection, color);
-                }
+        PROFILE_ZONE("RayCaster::castRays");
+        if constexpr (Cfg::hasRayStats()) {
+            stats.beginFrame();
+        }
+        if constexpr (Cfg::hasVisibleCells()) {
+            visible_cells.reset();
+        }
+        castColumns(g, x, y, view_angle, 0, view_width);
+    }
+
+    // draw sprites over the view rendered from (x, y, view_angle), hidden behind the walls in front of them. Call right
+    // after renderView(): with Cfg::hasVisibleCells(), sprites in cells it didn't see are culled before projecting. alpha places each sprite between its previous and current tick, see Sprite::at().
+    // The draw list is built in frame, eg. the frame's FrameArena, so drawing sprites never touches the heap.
+    void renderSprites(const Graphics& g, const int x, const int y, const int view_angle, std::span<const Sprite> sprites, std::pmr::memory_resource& frame, const float alpha = 1.0f) const {
+        PROFILE_ZONE("RayCaster::renderSprites");
+        struct Projected {
+            float distance;
+            int column; //center
+            int width, height; //on screen
+            int color;
+        };
+        FrameVector<Projected> visible{ &frame };
+        visible.reserve(sprites.size());
+        const float columns_per_radian = (FIXED_ONE / ANGLE_TO_RADIANS) / column_stride;
+        const int first_angle = view_angle - HALF_FOV_ANGLE; //of column 0
+        for (const auto& sprite : sprites) {
+            const auto s = sprite.at(alpha);
+            if constexpr (Cfg::hasVisibleCells()) { //no view ray passed through its cell: behind a wall, or off to the side
+                const int cell_x = s.x >> CELL_SIZE_FP;
+                const int cell_y = s.y >> CELL_SIZE_FP;
+                if (cell_x < 0 || cell_x >= WORLD_COLUMNS || cell_y < 0 || cell_y >= WORLD_ROWS || !visible_cells[cellIndex(cell_x, cell_y)]) { continue; }
             }
-            else { // must have hit a horizontal wall first                            
-                if (yray.intersection % CELL_SIZE > 1) {
-                    color = HORIZONTAL_WALL_COLOR;
-                }
-                if constexpr (Cfg::hasMinimap()) {
-                    MiniMap::drawLine(g, x, y, yray.intersection, yray.boundary, color);
+            const float dx = static_cast<float>(s.x - x);
+            const float dy = static_cast<float>(s.y - y);
+            const float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < 1.0f) { continue; } //we're standing in it
+            float angle = std::atan2(dy, dx) / ANGLE_TO_RADIANS - first_angle; //table angles from the left edge of the view
+            if (angle < -ANGLE_180) { angle += ANGLE_360; }
+            else if (angle >= ANGLE_180) { angle -= ANGLE_360; }
+            const int column = static_cast<int>(angle * FIXED_ONE / column_stride);
+            const int width = std::max(1, static_cast<int>(s.size / distance * columns_per_radian));
+            if (column + width / 2 < 0 || column - width / 2 >= view_width) { continue; }
+            //as tall as a wall this far away, and size / CELL_SIZE of that, so sprites and walls agree on scale
+            const int fov_index = std::clamp(static_cast<int>(angle), 0, HALF_FOV_ANGLE * 2 - 1);
+            const int height = static_cast<int>(cos_table[fov_index] * height_scale / distance * s.size / CELL_SIZE);
+            visible.push_back(Projected{ distance, column, width, std::max(height, 1), s.color });
+        }
+        std::sort(visible.begin(), visible.end(), [](const Projected& a, const Projected& b) { return a.distance > b.distance; }); //far to near
+        const int horizon = VIEWPORT_TOP + (view_height >> 1);
+        for (const auto& p : visible) {
+            const int clipped_height = std::min(p.height, view_height);
+            const int top = horizon - (clipped_height >> 1);
+            int color = p.color;
+            if constexpr (Cfg::hasDistanceShading()) {
+                color = ColorMap::index(colormap.lightLevel(p.distance), color);
+            }
+            g.setColor(color);
+            const int left = std::max(p.column - p.width / 2, 0);
+            const int right = std::min(p.column - p.width / 2 + p.width, view_width);
+            for (int column = left; column < right; column++) {
+                if (p.distance < depth_buffer[column]) {
+                    g.drawVerticalLine(column, top, clipped_height - 1);
                 }
             }
-            // height of the sliver is based on the inverse distance to the intersection. Closer is bigger, so: height = 1/dist. However, 1 is too low a factor to look good. Thus the constant K which has been pre-multiplied into the view-filter lookup-table.
-            const int height = static_cast<int>(cos_table[ray] / min_dist);
-            const int clipped_height = (height > Cfg::VIEWPORT_HEIGHT) ? Cfg::VIEWPORT_HEIGHT : height;
-            const int top = VIEWPORT_HORIZON - (clipped_height >> 1); //Optimization: height >> 1 == height / 2. slivers are drawn symmetrically around the viewport horizon.                       
-            const int sliver_x = ray;       
-            g.setColor(color);           
-            g.drawVerticalLine(sliver_x, top, clipped_height - 1);              
-            if (++view_angle == ANGLE_360) { 
-                view_angle = 0; //wrap angle back to zero
+        }
+    }
+
+    // late latching: the view was rendered at view_angle, but the camera has since turned by delta_angle. Shift the columns that
+    // are still valid sideways and re-cast only the ones that scrolled in at the edge. Returns false if nothing changed.
+    // Needs the indexed framebuffer that g draws into.
+    bool reproject(const Graphics& g, IndexedFrameBuffer& fb, const int x, const int y, const int view_angle, const int delta_angle) const noexcept {
+        PROFILE_ZONE("RayCaster::reproject");
+        const int shift = (delta_angle * FIXED_ONE) / column_stride; //in columns. Positive turns right, so the image moves left.
+        if (shift == 0) { return false; }
+        if (shift >= view_width || -shift >= view_width) { //turned too far, nothing to keep
+            if constexpr (Cfg::hasRayStats()) {
+                stats.beginFrame(); //the frame's stats are this cast's, like renderView()
             }
-        }  
+            if constexpr (Cfg::hasVisibleCells()) {
+                visible_cells.reset();
+            }
+            renderColumns(g, x, y, wrapAngle(view_angle + delta_angle), 0, view_width);
+            return true;
+        }
+        fb.scrollRegion({ VIEWPORT_LEFT, VIEWPORT_TOP, view_width, view_height }, -shift);
+        const int turned = wrapAngle(view_angle + ((shift * column_stride) >> 16)); //snap to whole columns, so kept and re-cast columns line up
+        if (shift > 0) {
+            renderColumns(g, x, y, turned, view_width - shift, view_width);
+        }
+        else {
+            renderColumns(g, x, y, turned, 0, -shift);
+        }
+        return true;
+    }
+
+    const RayStats& rayStats() const noexcept {
+        return stats;
+    }
+
+    // the open cells the view rays passed through on the way to their wall, this frame. Re-cast edge columns after
+    // reproject() are added to it. One shared answer to "what can the player see" for sprites, AI and the minimap.
+    const CellSet& visibleCells() const noexcept {
+        return visible_cells;
+    }
+
+    //the palette wall colors are drawn with. Graphics / IndexedFrameBuffer must use this as their palette.
+    //Without distance shading that is only the base colors (level 0), small enough for the pshufb expansion at present.
+    std::span<const SDL_Color> palette() const noexcept {
+        if constexpr (Cfg::hasDistanceShading()) {
+            return colormap.palette();
+        }
+        else {
+            return colormap.palette().first(PALETTE_SIZE);
+        }
     }
 
     void prettyPrintLUTs() const noexcept {
@@ -246,3 +448,5 @@ public:
         printTableData("cos_table", cos_table);
     }
 };
+
+using RayCaster = BasicRayCaster<isWall>; //the map selected by USE_BITMAP_LEVELDATA
@@ -0,0 +1,58 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include "Config.h"
+#include "LevelData.h"
+// Optional instrumentation of the wall searches (see Cfg::RAY_STATS): how many cells each ray visits and how many times it calls isWall().
+// Histograms are per frame, the per-cell visit counts accumulate over the whole session so we can see where rays spend their time.
+struct RayStats {
+	static constexpr auto BUCKETS = 2 * WORLD_ROWS + 1; //a ray is two axis casts, each can cross at most WORLD_ROWS cells
+	std::array<uint32_t, BUCKETS> cellsPerRay{}; //histogram: number of rays that visited N cells, this frame
+	std::array<uint32_t, BUCKETS> isWallPerRay{}; //histogram: number of rays that called isWall N times, this frame
+	std::array<uint32_t, WORLD_ROWS * WORLD_COLUMNS> cellVisits{}; //accumulated, [row * WORLD_COLUMNS + column]
+	uint32_t rays = 0; //this frame
+	uint64_t frameCells = 0;
+	uint64_t frameIsWallCalls = 0;
+	int rayCells = 0; //current ray
+	int rayIsWallCalls = 0;
+
+	void beginFrame() noexcept {
+		cellsPerRay.fill(0);
+		isWallPerRay.fill(0);
+		rays = 0;
+		frameCells = 0;
+		frameIsWallCalls = 0;
+	}
+	void beginRay() noexcept {
+		rayCells = 0;
+		rayIsWallCalls = 0;
+	}
+	void visit(int cell_x, int cell_y) noexcept { //called once per isWall() lookup
+		rayIsWallCalls++;
+		if (cell_x < 0 || cell_y < 0 || cell_x >= WORLD_COLUMNS || cell_y >= WORLD_ROWS) {
+			return; //out of bounds, isWall() answers without touching the map
+		}
+		rayCells++;
+		cellVisits[cell_y * WORLD_COLUMNS + cell_x]++;
+	}
+	void endRay() noexcept {
+		cellsPerRay[std::min(rayCells, BUCKETS - 1)]++;
+		isWallPerRay[std::min(rayIsWallCalls, BUCKETS - 1)]++;
+		frameCells += rayCells;
+		frameIsWallCalls += rayIsWallCalls;
+		rays++;
+	}
+	uint32_t maxCellVisits() const noexcept {
+		return *std::max_element(std::begin(cellVisits), std::end(cellVisits));
+	}
+	void print(std::ostream& out) const {
+		out << "rays: " << rays << ", cells visited: " << frameCells << ", isWall calls: " << frameIsWallCalls << "\n";
+		out << "steps | rays by cells visited | rays by isWall calls\n";
+		for (int i = 0; i < BUCKETS; i++) {
+			if (cellsPerRay[i] == 0 && isWallPerRay[i] == 0) { continue; }
+			out << i << ((i == BUCKETS - 1) ? "+" : "") << "\t| " << cellsPerRay[i] << "\t| " << isWallPerRay[i] << "\n";
+		}
+	}
+};
@@ -2,8 +2,8 @@
 #include "SDLSystem.h"
 #include "Window.h"
 #include <stdexcept>
-Renderer::Renderer(const Window& w): 
-	_ptr{ SDL_CreateRenderer(w.getRawPtr(), -1, SDL_RENDERER_ACCELERATED|SDL_RENDERER_PRESENTVSYNC)}{
+Renderer::Renderer(const Window& w, bool vsync): 
+	_ptr{ SDL_CreateRenderer(w.getRawPtr(), -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0))}{
 	if (!_ptr) {		
 		throw SDLError();
 	}
@@ -28,6 +28,10 @@ void Renderer::setColor(const SDL_Color& c) const noexcept {
 void Renderer::present() const noexcept {
 	SDL_RenderPresent(_ptr.get());
 }
+void Renderer::copy(SDL_Texture* t, const SDL_Rect* src, const SDL_Rect* dst) const noexcept {
+	int res = SDL_RenderCopy(_ptr.get(), t, src, dst);
+	SDL_assert(res == 0);
+}
 void Renderer::drawLine(int x1, int y1, int x2, int y2) const noexcept {
 	int res = SDL_RenderDrawLine(_ptr.get(), x1, y1, x2, y2);
 	SDL_assert(res == 0);
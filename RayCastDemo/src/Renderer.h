@@ -3,18 +3,20 @@
 struct SDL_Renderer;
 struct SDL_Color;
 struct SDL_Rect;
+struct SDL_Texture;
 class Window;
 class Renderer {		
 	SDLex::RendererPtr _ptr;
 	Renderer(const Renderer&) = delete; //disable copy constructor
 	Renderer& operator=(Renderer&) = delete; //disable copy assignment
 public:
-	Renderer(const Window& w);	
+	Renderer(const Window& w, bool vsync = true);	
 	void clear() const noexcept;
-	inline SDL_Renderer* getRawPtr() const noexcept;
+	SDL_Renderer* getRawPtr() const noexcept;
 	void setLogicalSize(int w, int h) const noexcept;
 	void setColor(const SDL_Color& c) const noexcept;
 	void present() const noexcept;
+	void copy(SDL_Texture* t, const SDL_Rect* src = nullptr, const SDL_Rect* dst = nullptr) const noexcept;
 	void drawLine(int x1, int y1, int x2, int y2) const noexcept;
 	void drawPoint(int x, int y) const noexcept;
 	void drawRect(const SDL_Rect& r) const noexcept;
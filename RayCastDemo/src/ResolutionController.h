@@ -0,0 +1,48 @@
+#pragma once
+#include "Config.h"
+#include "Utils.h"
+// Picks the internal render resolution from measured frame times, to stay within a frame-time budget.
+// Drops a step as soon as the (smoothed) frame time runs over budget, but only climbs back when there is clear headroom,
+// and waits a few frames after every change so we don't oscillate between two steps.
+class ResolutionController {
+	static constexpr auto STEPS = Cfg::RESOLUTION_STEPS;
+	static constexpr auto SMOOTHING = 0.1f; //weight of the newest sample in the moving average
+	static constexpr auto HEADROOM = 0.75f; //only step up if we're using less than this fraction of the budget
+	static constexpr auto COOLDOWN_FRAMES = 30;
+	float _budget_ms;
+	float _average_ms;
+	int _step = 0; //0 == full resolution, STEPS-1 == MIN_RESOLUTION_SCALE
+	int _cooldown = COOLDOWN_FRAMES;
+
+	static constexpr int scaled(int size, int step) noexcept {
+		const float scale = 1.0f - step * ((1.0f - Cfg::MIN_RESOLUTION_SCALE) / (STEPS - 1));
+		return static_cast<int>(size * scale + 0.5f);
+	}
+
+public:
+	explicit ResolutionController(float budget_ms = Cfg::FRAME_BUDGET_MS) noexcept
+		: _budget_ms(budget_ms), _average_ms(budget_ms * HEADROOM) {}
+
+	void update(float frame_ms) noexcept {
+		_average_ms += (frame_ms - _average_ms) * SMOOTHING;
+		if (_cooldown > 0) {
+			_cooldown--;
+			return;
+		}
+		if (_average_ms > _budget_ms && _step < STEPS - 1) {
+			_step++;
+			_cooldown = COOLDOWN_FRAMES;
+		}
+		else if (_average_ms < _budget_ms * HEADROOM && _step > 0) {
+			_step--;
+			_cooldown = COOLDOWN_FRAMES;
+		}
+	}
+	int width() const noexcept {
+		return Utils::clamp(scaled(Cfg::VIEWPORT_WIDTH, _step), 1, Cfg::VIEWPORT_WIDTH);
+	}
+	int height() const noexcept {
+		return Utils::clamp(scaled(Cfg::VIEWPORT_HEIGHT, _step) & ~1, 2, Cfg::VIEWPORT_HEIGHT); //keep it even, so the horizon stays centered
+	}
+	float averageFrameTime() const noexcept { return _average_ms; }
+};
@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include "Config.h"
+#include "ViewPoint.h"
+#include "Entities.h"
+#include "Broadphase.h"
+#include "GridTraversal.h"
+#include "JobPool.h"
+#include "Pool.h"
+#include "FrameArena.h"
+#include "Projectile.h"
+#include "Sprite.h"
+#include "Actions.h"
+#include "ActionRecorder.h"
+#include "Timer.h"
+#include "Profiler.h"
+//An immutable copy of everything the renderer needs from one simulation tick.
+struct Snapshot {
+	Camera previous{}; //camera at the tick before, for interpolation
+	Camera current{};
+	uint64_t tick = 0;
+	Uint64 timestamp = 0; //Timer::now() when the tick finished
+	Uint64 inputTime = 0; //event time of the newest input applied so far, for LatencyMeter
+	std::array<Sprite, Cfg::MAX_SPRITES> sprites{}; //the first spriteCount are in use
+	size_t spriteCount = 0;
+
+	//alpha is how far we are between the previous tick (0) and this tick (1)
+	Camera cameraAt(float alpha) const noexcept {
+		return Camera::lerp(previous, current, alpha);
+	}
+	std::span<const Sprite> spriteList() const noexcept {
+		return { sprites.data(), spriteCount };
+	}
+};
+
+// Everything that advances in fixed ticks. Keeps the camera from the previous tick, so we can render in-between ticks.
+class Simulation {
+	ViewPoint _viewPoint{ Cfg::START_POS_X, Cfg::START_POS_Y, ANGLE_0 };
+	Camera _previous = _viewPoint.camera();
+	uint64_t _tick = 0;
+	Uint64 _inputTime = 0;
+	ActionRecorder* _recorder = nullptr;
+	EntityStore _entities{ Cfg::ENTITY_COUNT };
+	Broadphase _broadphase{ Cfg::ENTITY_COUNT }; //who is near whom, as of the end of the last tick
+	JobPool* _jobs = nullptr;
+	Pool<Projectile> _projectiles{ Cfg::MAX_PROJECTILES };
+	int _fireCooldown = 0; //ticks until the next shot
+	FrameArena _scratch{ Cfg::TICK_ARENA_BYTES }; //for lists that only live during a tick. Reset every tick.
+	std::array<Sprite, Cfg::ACTOR_SPRITES> _actorSprites{}; //the actors nearest the player, to draw
+	size_t _actorSpriteCount = 0;
+	static constexpr auto WALLS = GridTraversal::wallRows<isWall>();
+
+	void spawnEntities() {
+		std::mt19937 rng(1); //seeded, so replays see the same actors
+		while (_entities.size() < _entities.capacity()) {
+			const int x = static_cast<int>(rng() % WORLD_COLUMNS);
+			const int y = static_cast<int>(rng() % WORLD_ROWS);
+			if (isWall(x, y)) { continue; }
+			const auto i = _entities.add(x * CELL_SIZE + (CELL_SIZE >> 1), y * CELL_SIZE + (CELL_SIZE >> 1), static_cast<int>(rng() % ANGLE_360));
+			_entities.setIntent(i, static_cast<int>(rng() % 5) - 2, 0.5f); //amble along slow curves
+		}
+	}
+
+	//needs this tick's broadphase
+	void selectActorSprites() noexcept {
+		struct Candidate {
+			int64_t distance; //squared
+			uint32_t actor;
+		};
+		//the only list in the tick's scratch, and never more than every actor: it can't overflow the arena onto the heap
+		static_assert(Cfg::ENTITY_COUNT * sizeof(Candidate) + alignof(Candidate) <= Cfg::TICK_ARENA_BYTES, "Raise TICK_ARENA_BYTES to fit a Candidate per actor");
+		FrameVector<Candidate> candidates{ &_scratch };
+		candidates.reserve(_entities.size());
+		const int x = _viewPoint.x, y = _viewPoint.y;
+		_broadphase.forEachInRadius(x, y, Cfg::ACTOR_SPRITE_RANGE, [&](uint32_t i) {
+			const int64_t dx = _entities.x(i) - x;
+			const int64_t dy = _entities.y(i) - y;
+			candidates.push_back(Candidate{ dx * dx + dy * dy, i });
+		});
+		_actorSpriteCount = std::min(candidates.size(), _actorSprites.size());
+		std::partial_sort(candidates.begin(), candidates.begin() + _actorSpriteCount, candidates.end(), [](const Candidate& a, const Candidate& b) {
+			return a.distance != b.distance ? a.distance < b.distance : a.actor < b.actor; //ties by index, so replays pick the same ones
+		});
+		for (size_t k = 0; k < _actorSpriteCount; k++) {
+			const auto i = candidates[k].actor;
+			_actorSprites[k] = Sprite{ _entities.x(i), _entities.y(i), 0, 0, CELL_SIZE / 2, paletteIndexOf(LightRed) };
+		}
+	}
+
+	void updateProjectiles(const Actions& input) noexcept {
+		_projectiles.removeIf([](Projectile& p) { return !p.update(isWall); });
+		if (_fireCooldown > 0) {
+			_fireCooldown--;
+		}
+		if (input.isDown(Actions::FIRE) && _fireCooldown == 0 && !_projectiles.full()) {
+			_projectiles.create(Projectile::fire(_viewPoint.x, _viewPoint.y, _viewPoint.angle));
+			_fireCooldown = Cfg::FIRE_INTERVAL;
+		}
+	}
+
+public:
+	Simulation() {
+		spawnEntities();
+	}
+	void setJobPool(JobPool* jobs) noexcept { //spread the entity update over these threads. Pass nullptr for this thread only.
+		_jobs = jobs;
+	}
+	void setRecorder(ActionRecorder* recorder) noexcept { //record every tick's input. Pass nullptr to stop.
+		_recorder = recorder;
+	}
+
+	//inputTime is the LatencyMeter stamp travelling with this input, if any
+	void tick(const Actions& input, Uint64 inputTime = 0) noexcept {
+		PROFILE_ZONE("Simulation::tick");
+		_scratch.reset();
+		if (_recorder) {
+			_recorder->record(input);
+		}
+		_previous = _viewPoint.camera();
+		{
+			PROFILE_ZONE("ViewPoint::update");
+			_viewPoint.update(input);
+		}
+		{
+			PROFILE_ZONE("ViewPoint::checkCollisions");
+			_viewPoint.checkCollisions();
+		}
+		if constexpr (Cfg::hasEntities()) {
+			PROFILE_ZONE("EntityStore::tick");
+			_entities.tick(WALLS, _jobs);
+		}
+		if constexpr (Cfg::hasEntities()) {
+			PROFILE_ZONE("Broadphase::rebuild");
+			_broadphase.rebuild(_entities.xs(), _entities.ys(), _jobs);
+		}
+		if constexpr (Cfg::hasEntities()) {
+			PROFILE_ZONE("Simulation::selectActorSprites");
+			selectActorSprites();
+		}
+		if constexpr (Cfg::hasProjectiles()) {
+			PROFILE_ZONE("Simulation::updateProjectiles");
+			updateProjectiles(input);
+		}
+		if (_viewPoint.teleported) {
+			_previous = _viewPoint.camera(); //snap, rather than sliding across the map
+		}
+		if (inputTime != 0) {
+			_inputTime = inputTime;
+		}
+		_tick++;
+	}
+
+	Camera camera() const noexcept {
+		return _viewPoint.camera();
+	}
+
+	const EntityStore& entities() const noexcept {
+		return _entities;
+	}
+
+	const Broadphase& broadphase() const noexcept {
+		return _broadphase;
+	}
+
+	const Pool<Projectile>& projectiles() const noexcept {
+		return _projectiles;
+	}
+
+	Snapshot snapshot() const noexcept {
+		Snapshot s{ _previous, _viewPoint.camera(), _tick, Timer::now(), _inputTime };
+		for (size_t k = 0; k < _actorSpriteCount; k++) {
+			s.sprites[s.spriteCount++] = _actorSprites[k];
+		}
+		for (const auto& p : _projectiles.items()) {
+			s.sprites[s.spriteCount++] = p.sprite();
+		}
+		return s;
+	}
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Config.h"
+#include "Simulation.h"
+#include "FixedTimestep.h"
+#include "TripleBuffer.h"
+#include "Profiler.h"
+// Runs the Simulation on its own thread, at Cfg::TICKS_PER_SECOND. Input goes in, and snapshots come out, through
+// lock-free triple buffers: a slow frame never delays a tick, and a slow tick never blocks a frame.
+class SimulationThread {
+	struct Input {
+		Actions actions{};
+		Uint64 inputTime = 0; //see LatencyMeter
+	};
+	Simulation _sim{};
+	TripleBuffer<Input> _input{};
+	TripleBuffer<Snapshot> _output{};
+	std::atomic<bool> _running{ false };
+	std::thread _thread;
+	Uint64 _tickLength = SDL_GetPerformanceFrequency() / Cfg::TICKS_PER_SECOND;
+	SimulationThread(const SimulationThread&) = delete; //disable copy constructor
+	SimulationThread& operator=(SimulationThread&) = delete; //disable copy assignment
+
+	void run() noexcept {
+		PROFILE_THREAD("simulation");
+		FixedTimestep clock{ Cfg::TICKS_PER_SECOND };
+		while (_running.load(std::memory_order_relaxed)) {
+			const int ticks = clock.advance();
+			if (ticks == 0) {
+				const auto remaining = (1.0f - clock.alpha()) * clock.tickSeconds();
+				std::this_thread::sleep_for(std::chrono::duration<double>(std::min(remaining, 0.001)));
+				continue;
+			}
+			for (int i = 0; i < ticks; i++) {
+				_input.update(); //keeps the last input if nothing new arrived
+				_sim.tick(_input.front().actions, _input.front().inputTime);
+			}
+			_output.publish(_sim.snapshot());
+		}
+	}
+
+public:
+	SimulationThread() {
+		_output.publish(_sim.snapshot()); //so there is something to render before the first tick
+	}
+	~SimulationThread() {
+		stop();
+	}
+	void start() {
+		_running = true;
+		_thread = std::thread(&SimulationThread::run, this);
+	}
+	void stop() noexcept {
+		_running = false;
+		if (_thread.joinable()) {
+			_thread.join();
+		}
+	}
+	void setRecorder(ActionRecorder* recorder) noexcept { //before start(). Written from the simulation thread, read it after stop().
+		assert(!_running && "SimulationThread: set the recorder before starting the thread");
+		_sim.setRecorder(recorder);
+	}
+	void setJobPool(JobPool* jobs) noexcept { //before start()
+		assert(!_running && "SimulationThread: set the job pool before starting the thread");
+		_sim.setJobPool(jobs);
+	}
+	void submit(const Actions& input, Uint64 inputTime = 0) noexcept { //render thread
+		_input.publish(Input{ input, inputTime });
+	}
+	const Snapshot& latest() noexcept { //render thread
+		_output.update();
+		return _output.front();
+	}
+	//how far the render thread is past the snapshot's tick, for interpolation
+	float alpha(const Snapshot& s) const noexcept {
+		const auto elapsed = static_cast<float>(Timer::now() - s.timestamp) / static_cast<float>(_tickLength);
+		return std::clamp(elapsed, 0.0f, 1.0f);
+	}
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include "Config.h"
+// What the renderer's sprite pass draws: a flat, colored square facing the camera, centered at eye height.
+// Plain data, so a tick's worth of them can travel to the render thread inside a Snapshot.
+struct Sprite {
+	int x = 0, y = 0; //center, in world units, at the tick
+	int dx = 0, dy = 0; //how far it moved during the tick, so it can be drawn in between ticks like the camera
+	int size = 0; //width and height, in world units. CELL_SIZE is as tall as a wall.
+	int color = 0; //palette index
+
+	//alpha is how far we are between the previous tick (0) and this tick (1)
+	Sprite at(float alpha) const noexcept {
+		const float behind = 1.0f - alpha;
+		return Sprite{ x - static_cast<int>(dx * behind), y - static_cast<int>(dy * behind), dx, dy, size, color };
+	}
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include "SDLSystem.h"
+//thin wrapper over SDL's high resolution counter. Safe to use before (or without) SDL_Init.
+namespace Timer {
+	inline Uint64 now() noexcept {
+		return SDL_GetPerformanceCounter();
+	}
+	inline double toSeconds(Uint64 ticks) noexcept {
+		static const double seconds_per_tick = 1.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+		return static_cast<double>(ticks) * seconds_per_tick;
+	}
+	inline double toMicroseconds(Uint64 ticks) noexcept {
+		return toSeconds(ticks) * 1000000.0;
+	}
+	inline double toMilliseconds(Uint64 ticks) noexcept {
+		return toSeconds(ticks) * 1000.0;
+	}
+	inline double millisecondsSince(Uint64 start) noexcept {
+		return toMilliseconds(now() - start);
+	}
+}
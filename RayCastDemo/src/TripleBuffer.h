@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+// Lock-free single-producer / single-consumer triple buffer. The writer fills back() and publish()es it,
+// the reader picks up the most recent publication with update() and reads front(). Neither side ever waits for the other;
+// if the writer is faster, the reader simply skips the stale buffers.
+template<typename T>
+class TripleBuffer {
+	static constexpr uint8_t INDEX_MASK = 0b011;
+	static constexpr uint8_t FRESH = 0b100; //set when the middle buffer holds something the reader hasn't seen
+	std::array<T, 3> _buffers{};
+	alignas(64) std::atomic<uint8_t> _middle{ 1 };
+	alignas(64) uint8_t _back = 0; //owned by the writer
+	alignas(64) uint8_t _front = 2; //owned by the reader
+	static_assert(std::atomic<uint8_t>::is_always_lock_free);
+
+public:
+	T& back() noexcept { //writer only
+		return _buffers[_back];
+	}
+	void publish() noexcept { //writer only
+		_back = _middle.exchange(_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+	void publish(const T& value) noexcept { //writer only
+		back() = value;
+		publish();
+	}
+	bool update() noexcept { //reader only. Returns false if nothing new was published.
+		if ((_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+			return false;
+		}
+		_front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+	const T& front() const noexcept { //reader only
+		return _buffers[_front];
+	}
+};
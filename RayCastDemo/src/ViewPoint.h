@@ -3,46 +3,69 @@
 #include "Config.h"
 #include "LevelData.h"
 #include "MiniMap.h"
-#include "InputManager.h"
+#include "Actions.h"
+#include "Movement.h"
+//the part of a ViewPoint that the renderer needs. Cheap to copy, so it can be kept per tick and interpolated.
+struct Camera {
+	int x = 0, y = 0, angle = 0;
+
+	static Camera lerp(const Camera& from, const Camera& to, float t) noexcept {
+		int delta_angle = to.angle - from.angle;
+		if (delta_angle > ANGLE_180) { delta_angle -= ANGLE_360; } //always turn the short way around
+		else if (delta_angle < -ANGLE_180) { delta_angle += ANGLE_360; }
+		int angle = from.angle + static_cast<int>(delta_angle * t);
+		if (angle < ANGLE_0) { angle += ANGLE_360; }
+		else if (angle >= ANGLE_360) { angle -= ANGLE_360; }
+		return Camera{
+			from.x + static_cast<int>((to.x - from.x) * t),
+			from.y + static_cast<int>((to.y - from.y) * t),
+			angle
+		};
+	}
+};
+
 struct ViewPoint {
 	int x = 0, y = 0, angle = 0;
 	float dx = 0.0f, dy = 0.0f;
+	bool teleported = false; //moved without walking there this update. Don't interpolate across it.
 	ViewPoint(int cellx, int celly, int startAngle) : angle{ startAngle } {
 		centerInCell(cellx, celly);
 	};
-	void update(const InputManager& input) {
+	Camera camera() const noexcept {
+		return Camera{ x, y, angle };
+	}
+	//how far one tick of this input turns the view, in table angles. Must match update().
+	static constexpr int turnRate(const Actions& input) noexcept {
+		if (input.isDown(Actions::ROTATE_LEFT)) { return -Cfg::ROTATION_SPEED; }
+		if (input.isDown(Actions::ROTATE_RIGHT)) { return Cfg::ROTATION_SPEED; }
+		return 0;
+	}
+	void update(const Actions& input) noexcept {
 		dx = 0.0f;
 		dy = 0.0f;
-		if (input.isButtonDown(MouseButton::LEFT)) {
-			const int mouseX = input.mouseX();
-			const int mouseY = input.mouseY();
-			const int mouseCellX = ((mouseX-MiniMap::MAP_LEFT) / MiniMap::SCALED_CELL_SIZE);
-			const int mouseCellY = mouseY / MiniMap::SCALED_CELL_SIZE;
-			std::cout << "x:" << mouseX << " y:" << mouseY << " / cellx:" << mouseCellX << " celly:" << mouseCellY << "\n";
-			if (!isWall(mouseCellX, mouseCellY)) {
-				centerInCell(mouseCellX, mouseCellY);
-				return;
-			}
+		teleported = false;
+		if (input.teleport && !isWall(input.teleportCellX, input.teleportCellY)) {
+			centerInCell(input.teleportCellX, input.teleportCellY);
+			return;
 		}
 
-		if (input.isAnyKeyDown(Cfg::rotateLeft)) {
+		if (input.isDown(Actions::ROTATE_LEFT)) {
 			if ((angle -= Cfg::ROTATION_SPEED) < ANGLE_0) {
 				angle = ANGLE_360;
 			}
 		}
-		else if (input.isAnyKeyDown(Cfg::rotateRight)) {
+		else if (input.isDown(Actions::ROTATE_RIGHT)) {
 			if ((angle += Cfg::ROTATION_SPEED) >= ANGLE_360) {
 				angle = ANGLE_0;
 			}
 		}
-		if (input.isAnyKeyDown(Cfg::moveForward)) {
-			dx = cos(angle * ANGLE_TO_RADIANS) * Cfg::WALK_SPEED;
-			dy = sin(angle * ANGLE_TO_RADIANS) * Cfg::WALK_SPEED;		
-
+		if (input.isDown(Actions::MOVE_FORWARD)) {
+			dx = Movement::WALK[angle].dx;
+			dy = Movement::WALK[angle].dy;
 		}
-		else if (input.isAnyKeyDown(Cfg::moveBackward)) {
-			dx = -cos(angle * ANGLE_TO_RADIANS) * Cfg::WALK_SPEED;
-			dy = -sin(angle * ANGLE_TO_RADIANS) * Cfg::WALK_SPEED;			
+		else if (input.isDown(Actions::MOVE_BACKWARD)) {
+			dx = -Movement::WALK[angle].dx;
+			dy = -Movement::WALK[angle].dy;
 		}
 		x += static_cast<int>(dx);
 		y += static_cast<int>(dy);
@@ -51,38 +74,23 @@ struct ViewPoint {
 	inline constexpr void centerInCell(int cellx, int celly) noexcept {
 		x = cellx * CELL_SIZE + (CELL_SIZE >> 1);
 		y = celly * CELL_SIZE + (CELL_SIZE >> 1);
+		teleported = true;
 	}
 
 	void checkCollisions() noexcept {
-		// test if user has bumped into a wall i.e. test if there is a cell within the direction of motion, if so back up!                               
-		const int x_cell = x / CELL_SIZE;
-		const int y_cell = y / CELL_SIZE;
-		if (isWall(x_cell, y_cell)) { //standing inside a wall, somehow. 
-			return centerInCell(FIRST_VALID_CELL, FIRST_VALID_CELL);
-		}
-
-		const int x_sub_cell = x % CELL_SIZE; // compute position within the cell
-		const int y_sub_cell = y % CELL_SIZE;
-		if (dx > 0 && isWall(x_cell + 1, y_cell)) {// moving right, towards a wall
-			if (x_sub_cell > (CELL_SIZE - OVERBOARD)) {
-				x -= (x_sub_cell - (CELL_SIZE - OVERBOARD)); // back player up amount they stepped over the line
-			}
-		}
-		else if (dx < 0 && isWall(x_cell - 1, y_cell)) {// moving left, towards a wall
-			if (x_sub_cell < (OVERBOARD)) {
-				x += (OVERBOARD - x_sub_cell);
+		if constexpr (Cfg::hasSweptCollision()) {
+			const int mx = static_cast<int>(dx);
+			const int my = static_cast<int>(dy);
+			x -= mx; //back to where this tick's move started, and sweep the whole of it
+			y -= my;
+			Movement::sweep(x, y, mx, my, Cfg::COLLISION_RADIUS, isWall);
+			if (isWall(x / CELL_SIZE, y / CELL_SIZE)) { //standing inside a wall, somehow.
+				centerInCell(FIRST_VALID_CELL, FIRST_VALID_CELL);
 			}
 		}
-
-		if (dy > 0 && isWall(x_cell, y_cell + 1)) { // moving up
-			if (y_sub_cell > (CELL_SIZE - OVERBOARD)) {
-				y -= (y_sub_cell - (CELL_SIZE - OVERBOARD));
-			}
-		}
-		else if (dy < 0 && isWall(x_cell, y_cell - 1)) {// moving down            
-			if (y_sub_cell < (OVERBOARD)) {
-				y += (OVERBOARD - y_sub_cell);
-			}
+		// test if user has bumped into a wall i.e. test if there is a cell within the direction of motion, if so back up!
+		else if (!Movement::pushOutOfWalls(x, y, dx, dy, isWall)) { //standing inside a wall, somehow.
+			centerInCell(FIRST_VALID_CELL, FIRST_VALID_CELL);
 		}
 	}
 };
\ No newline at end of file